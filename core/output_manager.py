@@ -10,8 +10,9 @@ from PySide6.QtCore import QObject, Signal, QSize, Qt, Slot, QTimer, QRect
 
 # Assume composition_renderer.py is in the same directory or a reachable path
 try:
-    from rendering.composition_renderer import CompositionRenderer
+    from rendering.composition_renderer import CompositionRenderer, FFmpegDecodeThread
 except ImportError:
+    FFmpegDecodeThread = None # No native video layer without the renderer's decoder
     # A fallback mock for standalone testing if the main renderer isn't available
     # Attempt to import decklink_handler for the DeckLinkTarget mock
     try:
@@ -161,34 +162,69 @@ class DeckLinkTarget(QObject):
     """Handles a single DeckLink output device."""
     error_occurred = Signal(str)
 
-    def __init__(self, fill_device_idx: int, key_device_idx: int, video_mode_details: Dict[str, Any], parent: Optional[QObject] = None):
+    def __init__(self, fill_device_idx: int, key_device_idx: int, video_mode_details: Dict[str, Any],
+                 output_options: Optional[Dict[str, Any]] = None, parent: Optional[QObject] = None):
         super().__init__(parent)
         self.fill_idx = fill_device_idx
         self.key_idx = key_device_idx
         self.mode_details = video_mode_details
+        self.output_options = output_options or {} # DLL output settings, see decklink_handler.make_output_config
+        self.internal_keying = self.output_options.get("keying_mode") == "internal" # Fill only; no key matte goes out
         self.is_active = False
+        self.input_capture_active = False # A DeckLink input is the background; frames go out as its overlay
         logging.info(f"DeckLinkTarget created for Fill:{fill_device_idx}, Key:{key_device_idx}, Mode:{video_mode_details.get('name', 'N/A') if video_mode_details else 'N/A'}")
 
     def initialize(self) -> bool:
         if not decklink_handler.decklink_dll and not decklink_handler.load_dll():
             self.error_occurred.emit("Failed to load DeckLink DLL.")
             return False
+        decklink_handler.forward_log_to_python_logging()
+        decklink_handler.set_log_level(self.output_options.get("log_level", "info"))
         if decklink_handler.decklink_dll.InitializeDLL() != decklink_handler.S_OK: # type: ignore
             self.error_occurred.emit("Failed to initialize DeckLink API (InitializeDLL).")
             return False
-        if not decklink_handler.initialize_selected_devices(self.fill_idx, self.key_idx, self.mode_details):
+        if not decklink_handler.initialize_selected_devices(self.fill_idx, self.key_idx, self.mode_details, self.output_options):
             self.error_occurred.emit(f"Failed to initialize DeckLink devices (Fill:{self.fill_idx}, Key:{self.key_idx}).")
             decklink_handler.decklink_dll.ShutdownDLL() # type: ignore
             return False
         self.is_active = True
+        capture_device = int(self.output_options.get("input_capture_device", -1))
+        if capture_device >= 0 and decklink_handler.supports_input_capture():
+            self.input_capture_active = decklink_handler.start_input_capture(capture_device)
+            if not self.input_capture_active:
+                logging.warning(f"DeckLinkTarget: Could not capture input device {capture_device}; output is not composited over it.")
         logging.info("DeckLinkTarget initialized successfully.")
         return True
 
-    def send_frame(self, fill_pixmap: QPixmap, key_matte_pixmap: QPixmap):
+    def reconfigure(self, video_mode_details: Dict[str, Any]) -> bool:
+        """Switches the open devices to another mode in place; False if the DLL refused (the target is unchanged)."""
+        if not self.is_active or self.input_capture_active or not decklink_handler.supports_reconfigure():
+            return False
+        if not decklink_handler.reconfigure_output(video_mode_details, self.output_options):
+            return False
+        self.mode_details = video_mode_details
+        logging.info(f"DeckLinkTarget reconfigured to Mode:{video_mode_details.get('name', 'N/A')}")
+        return True
+
+    def send_frame(self, fill_pixmap: QPixmap, key_matte_pixmap: Optional[QPixmap] = None):
+        """Sends a fill/key pair. Without a key matte the DLL derives the key from the fill's alpha."""
+        if self.input_capture_active:
+            self._send_capture_overlay(fill_pixmap)
+            return
+        if key_matte_pixmap is None or self.internal_keying:
+            self._send_fill_frame_auto_key(fill_pixmap)
+            return
         if not self.is_active or fill_pixmap.isNull() or key_matte_pixmap.isNull():
             logging.debug(f"DeckLinkTarget: Send frame skipped. Active: {self.is_active}, FillNull: {fill_pixmap.isNull()}, KeyNull: {key_matte_pixmap.isNull()}")
             return
 
+        # Preferred path: hand the frame to the DLL's output thread so the GUI never waits on the card
+        if decklink_handler.supports_frame_queue() and self._enqueue_frame(fill_pixmap, key_matte_pixmap):
+            return
+        # Next best: paint straight into the DLL's pooled frame memory (no intermediate copies)
+        if decklink_handler.supports_zero_copy_frames() and self._send_frame_in_place(fill_pixmap, key_matte_pixmap):
+            return
+
         # Convert QPixmaps to QImages, then to bytes
         fill_image = fill_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
         key_image = key_matte_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
@@ -203,14 +239,123 @@ class DeckLinkTarget(QObject):
         if not decklink_handler.send_external_keying_frames(fill_bytes, key_bytes):
             logging.error("DeckLinkTarget: decklink_handler.send_external_keying_frames reported failure.")
 
+    def _send_capture_overlay(self, fill_pixmap: QPixmap):
+        """While an input is captured, the rendered scene is the overlay the DLL draws over each captured frame."""
+        if not self.is_active or fill_pixmap.isNull():
+            return
+        if fill_pixmap.size() != QSize(decklink_handler.g_active_width, decklink_handler.g_active_height):
+            logging.debug("DeckLinkTarget: Overlay skipped; it must be full size while capturing.")
+            return
+        overlay_image = fill_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        if not decklink_handler.set_video_overlay(overlay_image):
+            logging.error("DeckLinkTarget: decklink_handler.set_video_overlay reported failure.")
+
+    def _enqueue_frame(self, fill_pixmap: QPixmap, key_matte_pixmap: Optional[QPixmap]) -> bool:
+        """Queues a full-size frame on the DLL's output thread. Returns False if the caller should fall back."""
+        target_size = QSize(decklink_handler.g_active_width, decklink_handler.g_active_height)
+        if fill_pixmap.size() != target_size or (key_matte_pixmap is not None and key_matte_pixmap.size() != target_size):
+            return False
+        fill_image = fill_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        key_image = key_matte_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied) if key_matte_pixmap is not None else None
+        if not decklink_handler.enqueue_fill_key_frame(fill_image, key_image):
+            logging.error("DeckLinkTarget: decklink_handler.enqueue_fill_key_frame reported failure.")
+        return True
+
+    def _send_frame_in_place(self, fill_pixmap: QPixmap, key_matte_pixmap: QPixmap) -> bool:
+        """Renders fill and key directly into a pooled DeckLink frame pair and commits it."""
+        target_size = QSize(decklink_handler.g_active_width, decklink_handler.g_active_height)
+        if fill_pixmap.size() != target_size or key_matte_pixmap.size() != target_size:
+            return False # The pooled frames keep stale content, so only full-size frames can be painted in
+
+        fill_image, key_image = decklink_handler.acquire_fill_key_frame()
+        if fill_image is None or key_image is None:
+            return False
+        try:
+            for target_image, source_pixmap in ((fill_image, fill_pixmap), (key_image, key_matte_pixmap)):
+                painter = QPainter(target_image)
+                painter.setCompositionMode(QPainter.CompositionMode.CompositionMode_Source)
+                painter.drawPixmap(0, 0, source_pixmap)
+                painter.end()
+        except Exception as e:
+            logging.error(f"DeckLinkTarget: Failed to render into DeckLink frame memory: {e}")
+            decklink_handler.cancel_fill_key_frame()
+            return False
+        if not decklink_handler.commit_fill_key_frame():
+            logging.error("DeckLinkTarget: decklink_handler.commit_fill_key_frame reported failure.")
+        return True
+
+    def _send_fill_frame_auto_key(self, fill_pixmap: QPixmap):
+        """Sends only the fill; the key matte is generated natively from its alpha channel."""
+        if not self.is_active or fill_pixmap.isNull():
+            logging.debug(f"DeckLinkTarget: Send frame skipped. Active: {self.is_active}, FillNull: {fill_pixmap.isNull()}")
+            return
+
+        if decklink_handler.supports_frame_queue() and self._enqueue_frame(fill_pixmap, None):
+            return
+        target_size = QSize(decklink_handler.g_active_width, decklink_handler.g_active_height)
+        if decklink_handler.supports_zero_copy_frames() and fill_pixmap.size() == target_size:
+            fill_image, _ = decklink_handler.acquire_fill_key_frame()
+            if fill_image is not None:
+                try:
+                    painter = QPainter(fill_image)
+                    painter.setCompositionMode(QPainter.CompositionMode.CompositionMode_Source)
+                    painter.drawPixmap(0, 0, fill_pixmap)
+                    painter.end()
+                except Exception as e:
+                    logging.error(f"DeckLinkTarget: Failed to render into DeckLink frame memory: {e}")
+                    decklink_handler.cancel_fill_key_frame()
+                else:
+                    if not decklink_handler.commit_fill_frame_auto_key():
+                        logging.error("DeckLinkTarget: decklink_handler.commit_fill_frame_auto_key reported failure.")
+                    return
+
+        fill_image = fill_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        fill_bytes = decklink_handler.get_image_bytes_from_qimage(fill_image)
+        if not fill_bytes:
+            logging.error("DeckLinkTarget: Failed to convert fill pixmap to bytes for sending.")
+            return
+        if not decklink_handler.send_fill_frame_auto_key(fill_bytes):
+            logging.error("DeckLinkTarget: decklink_handler.send_fill_frame_auto_key reported failure.")
+
+    def prefetch_frame(self, frame_id: int, fill_pixmap: QPixmap) -> bool:
+        """Converts a finished fill into the DLL's frame cache so take_cached_frame can cut to it later."""
+        if not self.is_active or self.input_capture_active or fill_pixmap.isNull() or not decklink_handler.supports_frame_cache():
+            return False
+        if not decklink_handler.supports_native_key_matte():
+            return False # The cache derives the key from the fill's alpha
+        if fill_pixmap.size() != QSize(decklink_handler.g_active_width, decklink_handler.g_active_height):
+            return False
+        fill_image = fill_pixmap.toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        return decklink_handler.cache_frame(frame_id, fill_image)
+
+    def take_cached_frame(self, frame_id: int, from_frame_id: Optional[int] = None) -> bool:
+        """Goes to a prefetched frame, with the configured take transition if from_frame_id (the
+        cached frame on air) is known, else as a cut. False if it is no longer cached; send the frame instead."""
+        if not self.is_active or self.input_capture_active:
+            return False
+        transition = self.output_options.get("take_transition", "cut")
+        duration_frames = int(self.output_options.get("transition_frames", 0))
+        if (transition != "cut" and duration_frames > 1 and from_frame_id is not None
+                and decklink_handler.start_transition(from_frame_id, frame_id, transition, duration_frames)):
+            return True
+        return decklink_handler.take_cached_frame(frame_id)
+
+    def evict_cached_frame(self, frame_id: int):
+        if self.is_active:
+            decklink_handler.evict_frame(frame_id)
+
     def shutdown(self):
         if self.is_active:
             logging.info("DeckLinkTarget: Shutting down devices and SDK.")
+            if self.input_capture_active:
+                decklink_handler.stop_input_capture()
+                self.input_capture_active = False
             decklink_handler.shutdown_selected_devices()
             if decklink_handler.decklink_dll: # Check if DLL is still loaded
                  hr_shutdown = decklink_handler.decklink_dll.ShutdownDLL() # type: ignore
                  if hr_shutdown != decklink_handler.S_OK:
                      logging.warning(f"DeckLinkTarget: ShutdownDLL returned HRESULT {hr_shutdown:#010x}")
+                 decklink_handler.set_log_callback(None) # Log queue is drained; don't call into Python during process exit
             self.is_active = False
         else:
             logging.info("DeckLinkTarget: Shutdown called but not active.")
@@ -238,12 +383,25 @@ class OutputManager(QObject):
         self.preview = OutputChannel("Preview", self.renderer)
         self.decklink_target: Optional[DeckLinkTarget] = None
         self._screen_output_window: Optional['OutputWindow'] = None # Reference to the screen output window
+        # DLL frame cache: the preview render is cached as it appears, so a take is one call
+        self._next_cached_frame_id = 1
+        self._preview_cached_frame_id: Optional[int] = None
+        self._program_cached_frame_id: Optional[int] = None
+        self._program_frame_sent_from_cache = False # The next program render is already on air
+        # DLL video layer: a full-frame video background is decoded straight to the card
+        self._native_video_thread: Optional['FFmpegDecodeThread'] = None
+        self._native_video_source: Optional[tuple] = None # (path, scaling_mode) being fed
+        self._native_video_loop = False
+        self._native_video_scene: Optional[Dict[str, Any]] = None # Program scene the overlay was rendered from
+        # DLL layers: the background is sent as layer 0 only when it changes, the lyrics over it as layer 1
+        self._native_layer_background_key: Optional[str] = None
         
         # Connect signals
         # Connect program channel's pixmap_updated to our own program_pixmap_updated
         self.program.pixmap_updated.connect(self._forward_program_pixmap)
         # Also connect program channel's pixmap_updated to update DeckLink if active
         self.program.pixmap_updated.connect(self._update_decklink_target_frame)
+        self.preview.pixmap_updated.connect(self._prefetch_preview_frame)
         self.renderer.needs_update.connect(self._on_renderer_update)
         logging.info("OutputManager initialized with Program and Preview channels.")
 
@@ -273,6 +431,16 @@ class OutputManager(QObject):
         """
         logging.info("OutputManager: TAKE command received. Moving Preview to Program.")
         preview_scene = self.preview._current_scene
+        if (self._preview_cached_frame_id is not None and self.decklink_target and self.decklink_target.is_active
+                and not self.preview.has_video()):
+            # The cached frame replaces the program outright, and _update_decklink_target_frame returns
+            # before _sync_native_video, so a video background would keep feeding the card over the take
+            self._stop_native_video()
+            if self.decklink_target.take_cached_frame(self._preview_cached_frame_id, self._program_cached_frame_id):
+                self._program_frame_sent_from_cache = True
+                if self._program_cached_frame_id not in (None, self._preview_cached_frame_id):
+                    self.decklink_target.evict_cached_frame(self._program_cached_frame_id)
+                self._program_cached_frame_id = self._preview_cached_frame_id
         self.program.update_scene(preview_scene)
         # The program.pixmap_updated signal will trigger _update_decklink_target_frame
 
@@ -298,8 +466,11 @@ class OutputManager(QObject):
         """
         logging.info("OutputManager: Renderer needs update (video frame). Checking channels.")
         if self.program.has_video():
-            logging.info("--> Program channel has video. Re-rendering.")
-            self.program.render()
+            if self._native_video_thread and not (self._screen_output_window and self._screen_output_window.isVisible()):
+                pass # The card is fed by the DLL video layer and no screen output needs the frame
+            else:
+                logging.info("--> Program channel has video. Re-rendering.")
+                self.program.render()
         
         if self.preview.has_video():
             logging.info("--> Preview channel has video. Re-rendering.")
@@ -310,16 +481,192 @@ class OutputManager(QObject):
         """Forwards the program channel's pixmap_updated signal."""
         self.program_pixmap_updated.emit(pixmap)
 
+    @Slot(QPixmap)
+    def _prefetch_preview_frame(self, preview_pixmap: QPixmap):
+        """Caches the new preview in the DLL so taking it does not send its pixels again."""
+        if not self.decklink_target or not self.decklink_target.is_active or self.preview.has_video():
+            self._preview_cached_frame_id = None # Video changes every frame; nothing to cache
+            return
+        previous_id = self._preview_cached_frame_id
+        frame_id = self._next_cached_frame_id
+        self._next_cached_frame_id += 1
+        self._preview_cached_frame_id = frame_id if self.decklink_target.prefetch_frame(frame_id, preview_pixmap) else None
+        if previous_id is not None and previous_id != self._program_cached_frame_id:
+            self.decklink_target.evict_cached_frame(previous_id)
+
     @Slot(QPixmap)
     def _update_decklink_target_frame(self, program_fill_pixmap: QPixmap):
         """Sends the current program frame to the active DeckLink target."""
+        if self._program_frame_sent_from_cache:
+            self._program_frame_sent_from_cache = False # take() already cut to this frame
+            return
+        if self._program_cached_frame_id is not None and self.decklink_target:
+            # Program no longer shows the cached frame, so a later take cannot transition from it
+            if self._program_cached_frame_id != self._preview_cached_frame_id:
+                self.decklink_target.evict_cached_frame(self._program_cached_frame_id)
+            self._program_cached_frame_id = None
+        if self.decklink_target and self.decklink_target.is_active and self._sync_native_video():
+            return # The DLL composites the overlay over the decoded video itself
+        if self.decklink_target and self.decklink_target.is_active and self._sync_native_layers():
+            return # The DLL composes the text over its cached background
         if self.decklink_target and self.decklink_target.is_active:
-            program_key_matte = self.program._generate_key_matte()
             logging.debug("OutputManager: Sending frame to active DeckLinkTarget.")
+            if decklink_handler.supports_native_key_matte():
+                # The DLL derives the key from the fill's alpha, identical to _generate_key_matte()
+                self.decklink_target.send_frame(program_fill_pixmap)
+                return
+            program_key_matte = self.program._generate_key_matte()
             self.decklink_target.send_frame(program_fill_pixmap, program_key_matte)
 
-    def enable_decklink_output(self, fill_idx: int, key_idx: int, mode_details: Optional[Dict[str, Any]]) -> bool:
+    @staticmethod
+    def _native_video_layers(scene: Optional[Dict[str, Any]]):
+        """Splits a scene into its video background and the layers over it, or None unless it has
+        exactly one full-frame, opaque video whose letterbox (if any) covers nothing."""
+        if not scene:
+            return None
+        layers = [layer for layer in scene.get('layers', []) if layer.get('visible', True)]
+        video_indices = [i for i, layer in enumerate(layers) if layer.get('type') == 'video']
+        if len(video_indices) != 1:
+            return None
+        index = video_indices[0]
+        video_layer = layers[index]
+        position = video_layer.get('position', {})
+        full_frame = (position.get('x_pc', 0), position.get('y_pc', 0), position.get('width_pc', 100), position.get('height_pc', 100)) == (0, 0, 100, 100)
+        scaling_mode = video_layer.get('properties', {}).get('scaling_mode', 'fit')
+        if not full_frame or video_layer.get('opacity', 1.0) < 1.0 or (index > 0 and scaling_mode == 'fit'):
+            return None
+        return video_layer, layers[index + 1:]
+
+    def _sync_native_video(self) -> bool:
+        """
+        Feeds a video background in the program scene straight to the DLL: FFmpeg frames go from the
+        decode thread to the card, and the rest of the scene is sent once as the overlay to draw over
+        them. Returns False (and stops any feed) if the scene cannot go that way; send it as rendered.
+        """
+        scene = self.program._current_scene
+        if self.decklink_target.input_capture_active:
+            self._stop_native_video()
+            return False # The captured input is the background; the whole scene goes out as its overlay
+        split = self._native_video_layers(scene) if FFmpegDecodeThread and decklink_handler.supports_video_layer() else None
+        if split is None:
+            self._stop_native_video()
+            return False
+        if scene is self._native_video_scene:
+            return True # Overlay already current; this is just a video-frame re-render
+        video_layer, overlay_layers = split
+        overlay_image = self.renderer.render_scene(dict(scene, layers=overlay_layers)).toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        if overlay_image.size() != QSize(decklink_handler.g_active_width, decklink_handler.g_active_height) or not decklink_handler.set_video_overlay(overlay_image):
+            self._stop_native_video()
+            return False
+        self._native_video_scene = scene
+        props = video_layer.get('properties', {})
+        self._native_video_loop = props.get('loop', False)
+        source = (props.get('path'), props.get('scaling_mode', 'fit'))
+        if source != self._native_video_source or not self._native_video_thread:
+            self._start_native_video(source)
+        return True
+
+    @staticmethod
+    def _native_layer_split(scene: Optional[Dict[str, Any]]):
+        """Splits a scene into its background (the leading colour and image layers) and the layers
+        over it, or None if it has no background or has a video (the video layer handles those)."""
+        if not scene:
+            return None
+        layers = [layer for layer in scene.get('layers', []) if layer.get('visible', True)]
+        if any(layer.get('type') == 'video' for layer in layers):
+            return None
+        count = 0
+        while count < len(layers) and layers[count].get('type') in ('solid_color', 'image'):
+            count += 1
+        if count == 0:
+            return None
+        return layers[:count], layers[count:]
+
+    @staticmethod
+    def _background_key(scene: Dict[str, Any], background_layers: List[Dict[str, Any]]) -> str:
+        """Identifies a background by what it draws; layer ids name the slide, so they are left out."""
+        drawn = [{key: value for key, value in layer.items() if key != 'id'} for layer in background_layers]
+        return json.dumps([scene.get('width'), scene.get('height'), drawn], sort_keys=True, default=str)
+
+    def _sync_native_layers(self) -> bool:
+        """
+        Sends the program scene as DLL layers: the background is rendered and sent only when it
+        changes, and the rest (the lyrics) as one transparent layer over it, which the DLL trims to
+        its text band. Returns False if the scene cannot go that way; send it as rendered.
+        """
+        if self.decklink_target.input_capture_active or not decklink_handler.supports_layers():
+            return False
+        scene = self.program._current_scene
+        split = self._native_layer_split(scene)
+        if split is None or QSize(scene.get('width', 1920), scene.get('height', 1080)) != QSize(decklink_handler.g_active_width, decklink_handler.g_active_height):
+            return False
+        background_layers, text_layers = split
+        background_key = self._background_key(scene, background_layers)
+        if background_key != self._native_layer_background_key:
+            background_image = self.renderer.render_scene(dict(scene, layers=background_layers)).toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+            if not decklink_handler.set_layer(0, background_image):
+                self._native_layer_background_key = None
+                return False
+            self._native_layer_background_key = background_key
+        text_image = None
+        if text_layers:
+            text_image = self.renderer.render_scene(dict(scene, layers=text_layers)).toImage().convertToFormat(QImage.Format.Format_ARGB32_Premultiplied)
+        return decklink_handler.set_layer(1, text_image) and decklink_handler.present_layers()
+
+    def _start_native_video(self, source: tuple):
+        self._stop_native_video_thread()
+        path, scaling_mode = source
+        mode = self.decklink_target.mode_details if self.decklink_target else {}
+        frame_rate = f"{mode['fr_num']}/{mode['fr_den']}" if mode.get('fr_num') and mode.get('fr_den') else None
+        thread = FFmpegDecodeThread(path, frame_sink=decklink_handler.enqueue_video_frame,
+                                    output_size=QSize(decklink_handler.g_active_width, decklink_handler.g_active_height),
+                                    frame_rate=frame_rate, scaling_mode=scaling_mode)
+        thread.finished.connect(self._on_native_video_finished)
+        self._native_video_thread = thread
+        self._native_video_source = source
+        thread.start()
+        logging.info(f"OutputManager: Feeding video '{path}' to the DeckLink video layer.")
+
+    def _stop_native_video_thread(self):
+        if self._native_video_thread:
+            self._native_video_thread.stop()
+            self._native_video_thread.wait(2000)
+            self._native_video_thread = None
+
+    def _stop_native_video(self):
+        if not self._native_video_thread and self._native_video_scene is None:
+            return
+        self._stop_native_video_thread()
+        self._native_video_source = None
+        self._native_video_scene = None
+        if self.decklink_target and self.decklink_target.is_active:
+            decklink_handler.set_video_overlay(None)
+
+    @Slot()
+    def _on_native_video_finished(self):
+        """End of file: loop the native feed if the layer loops."""
+        if self.sender() is not self._native_video_thread:
+            return # Replaced or stopped in the meantime
+        if self._native_video_loop and self._native_video_source:
+            self._start_native_video(self._native_video_source)
+        else:
+            self._stop_native_video_thread() # The overlay stays on the last frame
+
+    def enable_decklink_output(self, fill_idx: int, key_idx: int, mode_details: Optional[Dict[str, Any]],
+                               output_options: Optional[Dict[str, Any]] = None) -> bool:
         logging.info(f"OutputManager: Enabling DeckLink output. Fill:{fill_idx}, Key:{key_idx}, Mode:{mode_details.get('name', 'N/A') if mode_details else 'N/A'}")
+        self._stop_native_video()
+        target = self.decklink_target
+        if (target and mode_details is not None and target.fill_idx == fill_idx and target.key_idx == key_idx and
+                target.output_options == (output_options or {}) and target.reconfigure(mode_details)):
+            # Same devices, new mode: the DLL dropped its cache and layers, so start them again.
+            self._preview_cached_frame_id = None
+            self._program_cached_frame_id = None
+            self._native_layer_background_key = None
+            current_program_pixmap = self.program.get_current_pixmap()
+            if not current_program_pixmap.isNull():
+                self._update_decklink_target_frame(current_program_pixmap)
+            return True
         if self.decklink_target and self.decklink_target.is_active:
             logging.info("OutputManager: DeckLink already active, shutting down existing target first.")
             self.decklink_target.shutdown()
@@ -329,7 +676,10 @@ class OutputManager(QObject):
             logging.error("OutputManager: Cannot enable DeckLink output, video mode details are missing.")
             return False
 
-        self.decklink_target = DeckLinkTarget(fill_idx, key_idx, mode_details, parent=self)
+        self._preview_cached_frame_id = None # The new target starts with an empty cache
+        self._program_cached_frame_id = None
+        self.decklink_target = DeckLinkTarget(fill_idx, key_idx, mode_details, output_options, parent=self)
+        self._native_layer_background_key = None # A new device starts without layers
         self.decklink_target.error_occurred.connect(self.decklink_error_occurred) # Connect error signal
         if self.decklink_target.initialize():
             logging.info("OutputManager: DeckLink target initialized. Sending current program frame.")
@@ -345,6 +695,7 @@ class OutputManager(QObject):
 
     def disable_decklink_output(self):
         logging.info("OutputManager: Disabling DeckLink output.")
+        self._stop_native_video()
         if self.decklink_target:
             self.decklink_target.shutdown()
             try:
@@ -431,6 +782,7 @@ class OutputManager(QObject):
     def cleanup(self):
         """Cleans up resources, particularly the renderer's threads."""
         logging.info("OutputManager: Cleaning up resources.")
+        self._stop_native_video()
         if self.decklink_target:
             self.decklink_target.shutdown()
             # No need to disconnect here as decklink_target will be deleted if parent is self
@@ -42,6 +42,7 @@ try:
     from commands.slide_commands import AddSlideBlockToSectionCommand # Added for context menu
     from core.slide_drag_drop_handler import SlideDragDropHandler
     from commands.slide_commands import ChangeOverlayLabelCommand, ChangeBannerColorCommand # Import the commands
+    import decklink_handler # Batched thumbnail downsampling in the DeckLink DLL
 except ImportError as e:
     print(f"Warning: A local project file could not be imported in slide_ui_manager. Error: {e}", file=sys.stderr)
     # Add mocks if needed for testing in isolation
@@ -50,6 +51,7 @@ except ImportError as e:
 # --- Configuration ---
 logging.basicConfig(level=logging.INFO, format='%(asctime)s - %(levelname)s - %(message)s')
 BASE_PREVIEW_WIDTH = 160
+PREVIEW_RENDER_CHUNK = 16 # Full-res renders held at once while thumbnails are batched (~8 MB each at 1080p)
 
 
 class SlideUIManager(QObject):
@@ -126,6 +128,22 @@ class SlideUIManager(QObject):
         self.presentation_manager.presentation_changed.connect(self.refresh_slide_display)
         self.presentation_manager.slide_visual_property_changed.connect(self._handle_slide_visual_property_change)
 
+    def _scale_previews(self, full_res_pixmaps: List[QPixmap], width: int, height: int) -> List[QPixmap]:
+        """
+        Shrinks full-res renders to fit width x height, keeping aspect ratio. The whole batch goes
+        through the DLL's area filter in one call when it is available; otherwise each is scaled by Qt.
+        """
+        sizes = [pixmap.size().scaled(width, height, Qt.AspectRatioMode.KeepAspectRatio) for pixmap in full_res_pixmaps]
+        if full_res_pixmaps and all(not pixmap.isNull() and not size.isEmpty() and
+                                    size.width() <= pixmap.width() and size.height() <= pixmap.height()
+                                    for pixmap, size in zip(full_res_pixmaps, sizes)):
+            thumbnails = decklink_handler.downsample_images([pixmap.toImage() for pixmap in full_res_pixmaps],
+                                                            [(size.width(), size.height()) for size in sizes])
+            if thumbnails is not None:
+                return [QPixmap.fromImage(image) for image in thumbnails]
+        return [pixmap.scaled(width, height, Qt.AspectRatioMode.KeepAspectRatio, Qt.TransformationMode.SmoothTransformation)
+                for pixmap in full_res_pixmaps]
+
     def _build_scene_for_preview(self, slide_data: SlideData) -> Dict[str, Any]:
         """
         Creates a self-contained Scene dictionary for a single slide, suitable for generating a thumbnail.
@@ -253,6 +271,32 @@ class SlideUIManager(QObject):
         last_section_id = None
         current_flow_layout = None
 
+        # --- New Rendering Logic ---
+        # Slides missing a preview are rendered and downsampled PREVIEW_RENDER_CHUNK at a time, so only
+        # one chunk of full-res renders is alive however long the presentation is
+        pending_slides, pending_ids = [], set()
+        for slide_data in slides:
+            if slide_data.id not in self.preview_pixmap_cache and slide_data.id not in pending_ids:
+                pending_ids.add(slide_data.id)
+                pending_slides.append(slide_data)
+        for start in range(0, len(pending_slides), PREVIEW_RENDER_CHUNK):
+            chunk = pending_slides[start:start + PREVIEW_RENDER_CHUNK]
+            full_res_pixmaps = []
+            for slide_data in chunk:
+                scene_to_render = self._build_scene_for_preview(slide_data)
+                full_res_pixmap = self.renderer.render_scene(scene_to_render)
+                if full_res_pixmap:
+                    logging.debug(f"SlideUIManager.refresh: Rendered full-res pixmap for '{slide_data.id}' - Size: {full_res_pixmap.size()}, isNull: {full_res_pixmap.isNull()}")
+                else:
+                    logging.debug(f"SlideUIManager.refresh: Renderer returned None for full-res pixmap for '{slide_data.id}'.")
+                    full_res_pixmap = QPixmap()
+                full_res_pixmaps.append(full_res_pixmap)
+            for slide_data, preview_pixmap in zip(chunk, self._scale_previews(
+                    full_res_pixmaps, current_dynamic_preview_width, current_dynamic_preview_height)):
+                self.preview_pixmap_cache[slide_data.id] = preview_pixmap
+            full_res_pixmaps.clear() # Release this chunk's renders before the next is drawn
+        # --- End New Rendering Logic ---
+
         for index, slide_data in enumerate(slides):
             # Group slides by section
             if slide_data.section_id_in_manifest != last_section_id:
@@ -271,24 +315,8 @@ class SlideUIManager(QObject):
                 current_flow_layout = FlowLayout(container, margin=5, hSpacing=5, vSpacing=5)
                 self.slide_buttons_layout.addWidget(container)
 
-            # --- New Rendering Logic ---
             slide_id_str = slide_data.id
-            if slide_id_str not in self.preview_pixmap_cache:
-                scene_to_render = self._build_scene_for_preview(slide_data)
-                full_res_pixmap = self.renderer.render_scene(scene_to_render)
-                if full_res_pixmap:
-                    logging.debug(f"SlideUIManager.refresh: Rendered full-res pixmap for '{slide_id_str}' - Size: {full_res_pixmap.size()}, isNull: {full_res_pixmap.isNull()}")
-                else:
-                    logging.debug(f"SlideUIManager.refresh: Renderer returned None for full-res pixmap for '{slide_id_str}'.")
-
-                preview_pixmap = full_res_pixmap.scaled(
-                    current_dynamic_preview_width, current_dynamic_preview_height,
-                    Qt.AspectRatioMode.KeepAspectRatio, Qt.TransformationMode.SmoothTransformation
-                )
-                self.preview_pixmap_cache[slide_id_str] = preview_pixmap
-
             preview_pixmap = self.preview_pixmap_cache[slide_id_str]
-            # --- End New Rendering Logic ---
 
             # Call with positional arguments: (parent, slide_id, instance_id, mime_type)
             # The parent is the 'container' widget for the current FlowLayout.
@@ -420,10 +448,7 @@ class SlideUIManager(QObject):
                 else:
                     logging.debug(f"SlideUIManager.visual_change: Renderer returned None for full-res pixmap for '{slide_id_str}'.")
 
-                preview_pixmap = full_res_pixmap.scaled(
-                    current_dynamic_preview_width, current_dynamic_preview_height,
-                    Qt.AspectRatioMode.KeepAspectRatio, Qt.TransformationMode.SmoothTransformation
-                )
+                preview_pixmap = self._scale_previews([full_res_pixmap], current_dynamic_preview_width, current_dynamic_preview_height)[0]
                 button.set_pixmap(preview_pixmap)
                 self.preview_pixmap_cache[slide_id_str] = preview_pixmap
             except Exception as e:
@@ -2,6 +2,7 @@ import os
 import ctypes
 import sys
 import time # Added for the test section
+import logging
 try:
     from PySide6.QtGui import QImage, QColor, Qt
     from PySide6.QtCore import QRect, Signal, QObject
@@ -9,10 +10,17 @@ try:
 except ImportError:
     print("PySide6 library not found or QtGui/QtWidgets module missing. Please ensure PySide6 is installed.", file=sys.stderr)
     sys.exit(1)
+try:
+    import decklink_native # Optional buffer-protocol binding (DeckLinkPython.vcxproj), built next to the DLL
+except ImportError:
+    decklink_native = None
 
 # --- DeckLink DLL Configuration ---
 DLL_NAME = "DeckLinkWraper.dll" # Updated to match the C++ project output
 S_OK = 0  # HRESULT success code
+S_FALSE = 1 # HRESULT success code, e.g. an update skipped because the frame did not change
+E_NOTIMPL = 0x80004001
+E_INVALIDARG = 0x80070057
 DLL_WIDTH = 1920  # Match C++
 DLL_HEIGHT = 1080 # Match C++
 # Common frame rates (numerator, denominator)
@@ -59,14 +67,200 @@ def format_hresult(hr_code):
     return f"{unsigned_hr_code:#010x} ({description})"
 
 decklink_dll = None
+native_bound = False # True once decklink_native is bound to decklink_dll
 decklink_initialized_successfully = False # True if InitializeDevice was successful
 sdk_initialized_successfully = False # True if InitializeDLL was successful
 g_device_names = [] # Stores names of enumerated devices
+g_device_infos = [] # Per-device details from GetDeviceCatalog, parallel to g_device_names
 
-# Globals to store the dimensions of the currently initialized video mode
+# Globals to store the size frames are submitted at: the initialized video mode's, unless the DLL scales
 g_active_width = 0
 g_active_height = 0
 
+# ctypes views over the frame handed out by acquire_fill_key_frame(), kept alive until commit/cancel
+g_acquired_frame_buffers = None
+# Set when the active output cannot hand out paintable frames (YUV pixel formats)
+g_zero_copy_unavailable = False
+
+# --- DLL Config Structs (mirror DeckLinkWrapper.h; fields are append-only) ---
+FILL_ALPHA_PREMULTIPLIED = 0 # Fill goes out exactly as rendered
+FILL_ALPHA_STRAIGHT = 1      # DLL un-premultiplies the fill while copying it to the card
+FILL_ALPHA_MODES = {"premultiplied": FILL_ALPHA_PREMULTIPLIED, "straight": FILL_ALPHA_STRAIGHT}
+OUTPUT_PIXEL_FORMAT_BGRA = 0       # bmdFormat8BitBGRA
+OUTPUT_PIXEL_FORMAT_8BIT_YUV = 1   # bmdFormat8BitYUV ('2vuy'), converted in the DLL
+OUTPUT_PIXEL_FORMAT_10BIT_YUV = 2  # bmdFormat10BitYUV ('v210'), converted in the DLL
+OUTPUT_PIXEL_FORMATS = {"bgra": OUTPUT_PIXEL_FORMAT_BGRA, "2vuy": OUTPUT_PIXEL_FORMAT_8BIT_YUV, "v210": OUTPUT_PIXEL_FORMAT_10BIT_YUV}
+QUEUE_FULL_DROP_OLDEST = 0 # EnqueueFillKeyFrame replaces the oldest queued frame
+QUEUE_FULL_BLOCK = 1       # EnqueueFillKeyFrame waits for the output thread (with a timeout)
+QUEUE_FULL_POLICIES = {"drop_oldest": QUEUE_FULL_DROP_OLDEST, "block": QUEUE_FULL_BLOCK}
+KEYING_MODE_EXTERNAL = 0 # Fill and key on two connectors
+KEYING_MODE_INTERNAL = 1 # Fill only; the card's keyer uses the fill's alpha (BGRA output only)
+KEYING_MODES = {"external": KEYING_MODE_EXTERNAL, "internal": KEYING_MODE_INTERNAL}
+# DeckLinkFrameMemory (DeckLinkWrapper.h)
+FRAME_MEMORY_PRECOMMITTED = 0 # Wrapper allocator: page aligned, faulted in up front
+FRAME_MEMORY_LARGE_PAGES = 1 # Same on large pages when the account has "Lock pages in memory"
+FRAME_MEMORY_SDK_DEFAULT = 2
+TRANSITION_DISSOLVE = 0
+TRANSITION_WIPE = 1 # Left to right
+TRANSITION_TYPES = {"dissolve": TRANSITION_DISSOLVE, "wipe": TRANSITION_WIPE}
+LATENCY_PROFILE_FIXED = 0    # Always preroll_frames
+LATENCY_PROFILE_ADAPTIVE = 1 # Grows after late frames, shrinks back to preroll_frames once stable
+LATENCY_PROFILES = {"fixed": LATENCY_PROFILE_FIXED, "adaptive": LATENCY_PROFILE_ADAPTIVE}
+# DeckLinkReferenceStatus (DeckLinkWrapper.h)
+REFERENCE_STATUS_NAMES = {0: "not_supported", 1: "unlocked", 2: "locked"}
+
+FRAME_MEMORY_MODES = {"precommitted": FRAME_MEMORY_PRECOMMITTED, "large_pages": FRAME_MEMORY_LARGE_PAGES, "sdk": FRAME_MEMORY_SDK_DEFAULT}
+LOG_LEVEL_TRACE = 0 # Per-frame detail
+LOG_LEVEL_DEBUG = 1
+LOG_LEVEL_INFO = 2  # DLL default
+LOG_LEVEL_WARNING = 3
+LOG_LEVEL_ERROR = 4
+LOG_LEVEL_OFF = 5
+LOG_LEVELS = {"trace": LOG_LEVEL_TRACE, "debug": LOG_LEVEL_DEBUG, "info": LOG_LEVEL_INFO,
+              "warning": LOG_LEVEL_WARNING, "error": LOG_LEVEL_ERROR, "off": LOG_LEVEL_OFF}
+
+# void (*DeckLinkLogCallback)(int level, const char* message), called on the DLL's log thread
+DeckLinkLogCallback = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_char_p)
+DeckLinkOutputHandle = ctypes.c_void_p # Opaque; see CreateOutput
+
+class DeckLinkOutputConfig(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("fillAlphaMode", ctypes.c_int),
+        ("pixelFormat", ctypes.c_int),
+        ("workerThreadCount", ctypes.c_int),
+        ("submitQueueDepth", ctypes.c_int),
+        ("submitQueueFullPolicy", ctypes.c_int),
+        ("keyingMode", ctypes.c_int),
+        ("frameMemory", ctypes.c_int),
+        ("frameCacheMegabytes", ctypes.c_int),
+        ("latencyProfile", ctypes.c_int),
+        ("prerollFrames", ctypes.c_int),
+        ("sourceWidth", ctypes.c_int),
+        ("sourceHeight", ctypes.c_int),
+    ]
+
+class DeckLinkDirtyRect(ctypes.Structure):
+    _fields_ = [
+        ("x", ctypes.c_int),
+        ("y", ctypes.c_int),
+        ("width", ctypes.c_int),
+        ("height", ctypes.c_int),
+    ]
+
+class DeckLinkImage(ctypes.Structure):
+    _fields_ = [
+        ("data", ctypes.POINTER(ctypes.c_ubyte)),
+        ("width", ctypes.c_int),
+        ("height", ctypes.c_int),
+        ("rowBytes", ctypes.c_int),
+    ]
+
+class DeckLinkOutputStats(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("bufferedVideoFrames", ctypes.c_uint),
+        ("framesSubmitted", ctypes.c_ulonglong),
+        ("framesDisplayed", ctypes.c_ulonglong),
+        ("framesLate", ctypes.c_ulonglong),
+        ("framesDropped", ctypes.c_ulonglong),
+        ("framesFlushed", ctypes.c_ulonglong),
+        ("framesSkipped", ctypes.c_ulonglong),
+        ("queuedFramesReplaced", ctypes.c_ulonglong),
+        ("latencyMinMs", ctypes.c_double),
+        ("latencyAvgMs", ctypes.c_double),
+        ("latencyP99Ms", ctypes.c_double),
+        ("copyAvgMs", ctypes.c_double),
+        ("copyMaxMs", ctypes.c_double),
+        ("framesRepeated", ctypes.c_ulonglong),
+        ("underruns", ctypes.c_ulonglong),
+        ("prerollFrames", ctypes.c_int),
+    ]
+
+class DeckLinkInputStats(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("capturing", ctypes.c_int),
+        ("signalPresent", ctypes.c_int),
+        ("framesCaptured", ctypes.c_ulonglong),
+        ("framesWithoutSignal", ctypes.c_ulonglong),
+        ("framesRejected", ctypes.c_ulonglong),
+    ]
+
+class DeckLinkStreamTime(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("running", ctypes.c_int),
+        ("streamTime", ctypes.c_longlong),
+        ("timeScale", ctypes.c_longlong),
+        ("frameDuration", ctypes.c_longlong),
+        ("earliestCueTime", ctypes.c_longlong),
+        ("cuedStreamTime", ctypes.c_longlong),
+    ]
+
+class DeckLinkDisplayModeInfo(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("displayMode", ctypes.c_uint),
+        ("width", ctypes.c_int),
+        ("height", ctypes.c_int),
+        ("frameRateNum", ctypes.c_int),
+        ("frameRateDenom", ctypes.c_int),
+        ("pixelFormatMask", ctypes.c_uint),
+        ("name", ctypes.c_char * 64),
+    ]
+
+class DeckLinkDeviceInfo(ctypes.Structure):
+    _fields_ = [
+        ("structSize", ctypes.c_uint),
+        ("name", ctypes.c_char * 128),
+        ("modelName", ctypes.c_char * 128),
+        ("persistentId", ctypes.c_longlong),
+        ("topologicalId", ctypes.c_longlong),
+        ("subDeviceIndex", ctypes.c_int),
+        ("subDeviceCount", ctypes.c_int),
+        ("supportsInternalKeying", ctypes.c_int),
+        ("supportsExternalKeying", ctypes.c_int),
+        ("profileId", ctypes.c_uint),
+        ("profileName", ctypes.c_char * 64),
+        ("displayModeCount", ctypes.c_int),
+        ("pixelFormatMask", ctypes.c_uint),
+    ]
+
+def make_output_config(output_options: dict = None) -> DeckLinkOutputConfig:
+    """Builds a DeckLinkOutputConfig from an options dict, e.g. {"fill_alpha_mode": "straight", "pixel_format": "v210"}."""
+    options = output_options or {}
+    config = DeckLinkOutputConfig()
+    config.structSize = ctypes.sizeof(DeckLinkOutputConfig)
+    config.fillAlphaMode = FILL_ALPHA_MODES.get(options.get("fill_alpha_mode", "premultiplied"), FILL_ALPHA_PREMULTIPLIED)
+    config.pixelFormat = OUTPUT_PIXEL_FORMATS.get(options.get("pixel_format", "bgra"), OUTPUT_PIXEL_FORMAT_BGRA)
+    config.workerThreadCount = int(options.get("worker_threads", 0)) # 0 = let the DLL choose
+    config.submitQueueDepth = int(options.get("submit_queue_depth", 0)) # 0 = DLL default
+    config.submitQueueFullPolicy = QUEUE_FULL_POLICIES.get(options.get("submit_queue_policy", "drop_oldest"), QUEUE_FULL_DROP_OLDEST)
+    config.keyingMode = KEYING_MODES.get(options.get("keying_mode", "external"), KEYING_MODE_EXTERNAL)
+    config.frameMemory = FRAME_MEMORY_MODES.get(options.get("frame_memory", "precommitted"), FRAME_MEMORY_PRECOMMITTED)
+    config.frameCacheMegabytes = int(options.get("frame_cache_mb", 0)) # 0 = DLL default
+    config.latencyProfile = LATENCY_PROFILES.get(options.get("latency_profile", "fixed"), LATENCY_PROFILE_FIXED)
+    config.prerollFrames = int(options.get("preroll_frames", 0)) # 0 = DLL default (2)
+    config.sourceWidth, config.sourceHeight = _source_size(options, 0, 0) # 0 = the mode's size
+    return config
+
+def _read_source_size(read, *args):
+    """The caller frame size the DLL reads from every buffer, or None if it cannot say."""
+    width, height = ctypes.c_int(0), ctypes.c_int(0)
+    if read(*args, ctypes.byref(width), ctypes.byref(height)) != S_OK:
+        return None
+    return width.value, height.value
+
+def _source_size(options: dict, mode_width: int, mode_height: int):
+    """The size frames are rendered and submitted at: options' source_width/source_height (the DLL
+    scales them up to the mode), or the mode's own size."""
+    source_width = int((options or {}).get("source_width", 0))
+    source_height = int((options or {}).get("source_height", 0))
+    if source_width <= 0 or source_height <= 0:
+        return mode_width, mode_height
+    return source_width, source_height
+
 # --- Expected DLL Function Signatures ---
 # Store expected functions and their ctypes setup
 EXPECTED_FUNCTIONS = {
@@ -74,24 +268,144 @@ EXPECTED_FUNCTIONS = {
     "ShutdownDLL": {"restype": HRESULT, "argtypes": []},
     "GetDeviceCount": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_int)]},
     "GetDeviceName": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_char_p, ctypes.c_int]},
+    # Device catalogue: per-device output modes in one call, and a counter bumped on hot-plug
+    "GetDisplayModes": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.POINTER(DeckLinkDisplayModeInfo), ctypes.c_int, ctypes.POINTER(ctypes.c_int)]},
+    "GetDeviceCatalogGeneration": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_uint)]},
+    "GetDeviceCatalog": {"restype": HRESULT, "argtypes": [ctypes.POINTER(DeckLinkDeviceInfo), ctypes.c_int, ctypes.POINTER(ctypes.c_int)]},
     # InitializeDevice now takes fill_idx, key_idx, w, h, frNum, frDenom
     "InitializeDevice": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]},
+    # InitializeDeviceEx adds a DeckLinkOutputConfig* (may be NULL for defaults)
+    "InitializeDeviceEx": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.POINTER(DeckLinkOutputConfig)]},
     "ShutdownDevice": {"restype": HRESULT, "argtypes": []},
     # UpdateOutputFrame is now UpdateExternalKeyingFrames, taking two frame pointers
     "UpdateExternalKeyingFrames": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    # Dirty-rect variant: only the listed regions are compared and copied (key may be NULL)
+    "UpdateExternalKeyingFramesDirty": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(DeckLinkDirtyRect), ctypes.c_int]},
+    "GetSkippedFrameCount": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ulonglong)]},
+    "GetOutputStats": {"restype": HRESULT, "argtypes": [ctypes.POINTER(DeckLinkOutputStats)]},
+    "GetReferenceStatus": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_int)]},
+    # Zero-copy path: render straight into pooled DeckLink frame memory, then commit
+    "AcquireFillKeyFrame": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_long)]},
+    "CommitFillKeyFrame": {"restype": HRESULT, "argtypes": []},
+    "CancelFillKeyFrame": {"restype": HRESULT, "argtypes": []},
+    # Native key matte: the DLL derives the key from the fill's alpha channel
+    "UpdateFillAutoKey": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte)]},
+    "CommitFillFrameAutoKey": {"restype": HRESULT, "argtypes": []},
+    # Asynchronous submit: copies the frame and returns; a DLL output thread schedules it (key may be NULL)
+    "EnqueueFillKeyFrame": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    # Frame cache: convert a finished frame once, later cut to it by id without sending pixels
+    "CacheFrame": {"restype": HRESULT, "argtypes": [ctypes.c_ulonglong, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    "TakeCachedFrame": {"restype": HRESULT, "argtypes": [ctypes.c_ulonglong]},
+    "EvictFrame": {"restype": HRESULT, "argtypes": [ctypes.c_ulonglong]},
+    # Video layer: decoded video frames go out with a DLL-composited overlay, no per-frame re-render
+    "SetVideoOverlay": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte)]},
+    "EnqueueVideoFrame": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte)]},
+    # Layers: a cached background and text layers the output thread composes into each presented frame
+    "SetLayer": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.POINTER(ctypes.c_ubyte), ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_ubyte]},
+    "SetLayerPlacement": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_ubyte]},
+    "ClearLayers": {"restype": HRESULT, "argtypes": []},
+    "PresentLayers": {"restype": HRESULT, "argtypes": []},
+    # Shared textures: D3D11-rendered frames, copied on the GPU and read back by the output thread
+    "EnqueueSharedTexture": {"restype": HRESULT, "argtypes": [ctypes.c_void_p, ctypes.c_int, ctypes.c_ulonglong, ctypes.c_ulonglong]},
+    # Transitions between two cached frames, generated and scheduled by the DLL's output thread
+    "StartTransition": {"restype": HRESULT, "argtypes": [ctypes.c_ulonglong, ctypes.c_ulonglong, ctypes.c_int, ctypes.c_int]},
+    # Cued takes: a frame (or cached frame) put on air at an exact stream time of the card's clock
+    "CueFrame": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte), ctypes.c_longlong]},
+    "CueCachedFrame": {"restype": HRESULT, "argtypes": [ctypes.c_ulonglong, ctypes.c_longlong]},
+    "CancelCue": {"restype": HRESULT, "argtypes": []},
+    "GetStreamTime": {"restype": HRESULT, "argtypes": [ctypes.POINTER(DeckLinkStreamTime)]},
+    "ReconfigureOutput": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]},
+    "GetSourceFrameSize": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]},
+    # Logging: level filter and an optional sink replacing the DLL's stdout
+    "SetLogLevel": {"restype": HRESULT, "argtypes": [ctypes.c_int]},
+    "SetLogCallback": {"restype": HRESULT, "argtypes": [DeckLinkLogCallback]},
     # Keyer functions
     "EnableKeyer": {"restype": HRESULT, "argtypes": [ctypes.c_bool]},
     "DisableKeyer": {"restype": HRESULT, "argtypes": []},
     "SetKeyerLevel": {"restype": HRESULT, "argtypes": [ctypes.c_ubyte]},
     "IsKeyerActive": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_bool)]},
-    "GetAPIVersion": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_longlong)]}
+    "GetAPIVersion": {"restype": HRESULT, "argtypes": [ctypes.POINTER(ctypes.c_longlong)]},
+    # Output handles: independent fill/key pairs, each with its own frame pool and output thread
+    "CreateOutput": {"restype": HRESULT, "argtypes": [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.POINTER(DeckLinkOutputConfig), ctypes.POINTER(DeckLinkOutputHandle)]},
+    "DestroyOutput": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "UpdateFrames": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    "UpdateFramesDirty": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(DeckLinkDirtyRect), ctypes.c_int]},
+    "EnqueueFrames": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    "GetOutputStatsByHandle": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(DeckLinkOutputStats)]},
+    "GetOutputReferenceStatus": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_int)]},
+    "CacheOutputFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ulonglong, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte)]},
+    "TakeOutputCachedFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ulonglong]},
+    "EvictOutputFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ulonglong]},
+    "SetOutputVideoOverlay": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte)]},
+    "EnqueueOutputVideoFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte)]},
+    "EnqueueOutputSharedTexture": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_void_p, ctypes.c_int, ctypes.c_ulonglong, ctypes.c_ulonglong]},
+    "SetOutputLayer": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_int, ctypes.POINTER(ctypes.c_ubyte), ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_ubyte]},
+    "SetOutputLayerPlacement": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_ubyte]},
+    "ClearOutputLayers": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "PresentOutputLayers": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "StartOutputTransition": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ulonglong, ctypes.c_ulonglong, ctypes.c_int, ctypes.c_int]},
+    "CueOutputFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_ubyte), ctypes.POINTER(ctypes.c_ubyte), ctypes.c_longlong]},
+    "CueOutputCachedFrame": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ulonglong, ctypes.c_longlong]},
+    "CancelOutputCue": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "ReconfigureOutputByHandle": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_int]},
+    "GetOutputSourceFrameSize": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]},
+    "GetOutputStreamTime": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(DeckLinkStreamTime)]},
+    "EnableOutputKeyer": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_bool]},
+    "DisableOutputKeyer": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "SetOutputKeyerLevel": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_ubyte]},
+    "StartInputCapture": {"restype": HRESULT, "argtypes": [ctypes.c_int]},
+    "StopInputCapture": {"restype": HRESULT, "argtypes": []},
+    "GetInputCaptureStats": {"restype": HRESULT, "argtypes": [ctypes.POINTER(DeckLinkInputStats)]},
+    "StartOutputCapture": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.c_int]},
+    "StopOutputCapture": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle]},
+    "GetOutputCaptureStats": {"restype": HRESULT, "argtypes": [DeckLinkOutputHandle, ctypes.POINTER(DeckLinkInputStats)]},
+    "DownsampleBatch": {"restype": HRESULT, "argtypes": [ctypes.POINTER(DeckLinkImage), ctypes.c_int, ctypes.POINTER(DeckLinkImage), ctypes.c_int]}
 }
 
+# Keeps the registered ctypes callback alive for as long as the DLL may call it
+g_log_callback = None
+
+def set_log_level(level) -> bool:
+    """Sets the DLL's log level, either a LOG_LEVELS name ("trace" ... "off") or a LOG_LEVEL_* value."""
+    if not decklink_dll or not hasattr(decklink_dll, "SetLogLevel"):
+        return False
+    level_value = LOG_LEVELS.get(level, LOG_LEVEL_INFO) if isinstance(level, str) else int(level)
+    return decklink_dll.SetLogLevel(level_value) == S_OK
+
+def set_log_callback(callback) -> bool:
+    """
+    Routes DLL log messages to callback(level: int, message: str) instead of the DLL's stdout.
+    The callback runs on the DLL's log thread. Pass None to go back to stdout.
+    """
+    global g_log_callback
+    if not decklink_dll or not hasattr(decklink_dll, "SetLogCallback"):
+        return False
+    if callback is None:
+        c_callback = ctypes.cast(None, DeckLinkLogCallback)
+    else:
+        def _forward(level, message):
+            try:
+                callback(level, message.decode("utf-8", errors="replace") if message else "")
+            except Exception: # Never let an exception unwind into the DLL
+                pass
+        c_callback = DeckLinkLogCallback(_forward)
+    hr = decklink_dll.SetLogCallback(c_callback)
+    g_log_callback = c_callback if callback is not None else None # Old callback may be freed: the DLL no longer calls it
+    return hr == S_OK
+
+_DLL_LOG_LEVEL_TO_LOGGING = {LOG_LEVEL_TRACE: logging.DEBUG, LOG_LEVEL_DEBUG: logging.DEBUG, LOG_LEVEL_INFO: logging.INFO,
+                             LOG_LEVEL_WARNING: logging.WARNING, LOG_LEVEL_ERROR: logging.ERROR}
+
+def forward_log_to_python_logging(logger_name: str = "DeckLinkWrapper") -> bool:
+    """Sends the DLL's log messages to the Python logging module under logger_name."""
+    logger = logging.getLogger(logger_name)
+    return set_log_callback(lambda level, message: logger.log(_DLL_LOG_LEVEL_TO_LOGGING.get(level, logging.INFO), message))
+
 def get_project_root():
     return os.path.dirname(os.path.abspath(__file__))
 
 def load_dll():
-    global decklink_dll
+    global decklink_dll, native_bound
     project_root = get_project_root()
             
     dll_path_found = os.path.join(project_root, DLL_NAME)
@@ -124,6 +438,14 @@ def load_dll():
         # if not all_expected_found:
         #     print("Warning: Not all expected DLL interfaces were found.", file=sys.stderr)
 
+        native_bound = False
+        if decklink_native is not None:
+            try:
+                bound_count = decklink_native.bind(decklink_dll._handle) # Same DLL instance as ctypes
+                native_bound = bound_count > 0
+                print(f"  [ OK ] decklink_native bound to {bound_count} frame export(s).")
+            except (OSError, TypeError, ValueError) as e:
+                print(f"  [WARN] decklink_native could not bind: {e}")
         return True
     except OSError as e:
         print(f"Error loading DLL from {dll_path_found}: {e}", file=sys.stderr)
@@ -186,12 +508,72 @@ def initialize_sdk():
     sdk_initialized_successfully = True
     return True, api_version_to_return
 
+def get_device_catalog():
+    """
+    Every device in one DLL call, as dicts (index, name, model_name, persistent_id, topological_id,
+    sub_device_index, sub_device_count, supports_internal_keying, supports_external_keying,
+    profile_id, profile_name, display_mode_count, pixel_formats) in device index order.
+    Renumbers the devices like GetDeviceCount. None if the DLL has no GetDeviceCatalog.
+    """
+    if not decklink_dll or not hasattr(decklink_dll, "GetDeviceCatalog"):
+        return None
+    count = ctypes.c_int(0)
+    hr = decklink_dll.GetDeviceCatalog(None, 0, ctypes.byref(count))
+    # A device may arrive between the sizing call and the fill; the second call renumbers, so size again
+    for _ in range(3):
+        if hr != S_OK:
+            print(f"GetDeviceCatalog failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+            return None
+        if count.value == 0:
+            return []
+        capacity = count.value
+        infos = (DeckLinkDeviceInfo * capacity)()
+        infos[0].structSize = ctypes.sizeof(DeckLinkDeviceInfo)
+        hr = decklink_dll.GetDeviceCatalog(infos, capacity, ctypes.byref(count))
+        if hr == S_OK and count.value <= capacity:
+            break
+    else:
+        return None
+
+    devices = []
+    for index, info in enumerate(infos[:count.value]):
+        devices.append({
+            "index": index,
+            "name": info.name.decode("utf-8", errors="replace"),
+            "model_name": info.modelName.decode("utf-8", errors="replace"),
+            "persistent_id": info.persistentId,
+            "topological_id": info.topologicalId,
+            "sub_device_index": info.subDeviceIndex,
+            "sub_device_count": info.subDeviceCount,
+            "supports_internal_keying": bool(info.supportsInternalKeying),
+            "supports_external_keying": bool(info.supportsExternalKeying),
+            "profile_id": info.profileId,
+            "profile_name": info.profileName.decode("utf-8", errors="replace"),
+            "display_mode_count": info.displayModeCount,
+            "pixel_formats": [name for name, bit in OUTPUT_PIXEL_FORMATS.items() if info.pixelFormatMask & (1 << bit)],
+        })
+    return devices
+
 def enumerate_devices():
     """Enumerates available DeckLink devices. Assumes SDK is initialized."""
-    global g_device_names
+    global g_device_names, g_device_infos
     if not sdk_initialized_successfully:
         print("SDK not initialized. Cannot enumerate devices.", file=sys.stderr)
         return []
+
+    device_infos = get_device_catalog()
+    if device_infos is not None:
+        g_device_infos = device_infos
+        g_device_names = [info["name"] for info in device_infos]
+        if not g_device_names:
+            print("No DeckLink devices found.")
+            return []
+        print(f"Found {len(g_device_names)} DeckLink device(s):")
+        for info in device_infos:
+            print(f"  Device {info['index']}: {info['name']} ({info['profile_name'] or 'profile unknown'})")
+        return g_device_names
+    g_device_infos = []
+
     if not hasattr(decklink_dll, "GetDeviceCount") or not hasattr(decklink_dll, "GetDeviceName"):
         print("Error: GetDeviceCount or GetDeviceName not found in DLL. Cannot enumerate devices.", file=sys.stderr)
         return []
@@ -224,13 +606,76 @@ def enumerate_devices():
         print(f"  Device {i}: {name}")
     return g_device_names
 
-def initialize_selected_devices(fill_device_idx: int, key_device_idx: int, video_mode_details: dict) -> bool:
-    global decklink_initialized_successfully, g_active_width, g_active_height
+def _format_frame_rate(fr_num: int, fr_den: int) -> str:
+    return f"{fr_num / fr_den:.2f}".rstrip("0").rstrip(".")
+
+def get_display_modes(device_index: int):
+    """
+    Output modes the device at device_index (as numbered by enumerate_devices) supports, as dicts
+    with name, width, height, fr_num, fr_den and pixel_formats. None if the DLL cannot report
+    them, so callers can fall back to their own list.
+    """
+    if not sdk_initialized_successfully or not hasattr(decklink_dll, "GetDisplayModes"):
+        return None
+    count = ctypes.c_int(0)
+    hr = decklink_dll.GetDisplayModes(device_index, None, 0, ctypes.byref(count))
+    if hr != S_OK:
+        print(f"GetDisplayModes failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+    if count.value == 0:
+        return []
+    infos = (DeckLinkDisplayModeInfo * count.value)()
+    infos[0].structSize = ctypes.sizeof(DeckLinkDisplayModeInfo)
+    hr = decklink_dll.GetDisplayModes(device_index, infos, count.value, ctypes.byref(count))
+    if hr != S_OK:
+        print(f"GetDisplayModes failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+
+    modes = []
+    for info in infos[:min(count.value, len(infos))]:
+        pixel_formats = [name for name, bit in OUTPUT_PIXEL_FORMATS.items() if info.pixelFormatMask & (1 << bit)]
+        modes.append({
+            "name": f"{info.width}x{info.height} @ {_format_frame_rate(info.frameRateNum, info.frameRateDenom)}",
+            "sdk_name": info.name.decode("utf-8", errors="replace"),
+            "width": info.width, "height": info.height,
+            "fr_num": info.frameRateNum, "fr_den": info.frameRateDenom,
+            "pixel_formats": pixel_formats,
+        })
+    # Interlaced/PsF variants share a size and rate with a progressive mode the SDK lists first;
+    # that one keeps the plain label (the one saved settings use), later ones get the SDK name
+    seen_labels = set()
+    for mode in modes:
+        if mode["name"] in seen_labels:
+            mode["name"] = f'{mode["name"]} ({mode["sdk_name"]})'
+        seen_labels.add(mode["name"])
+    return modes
+
+def get_device_catalog_generation():
+    """Counter the DLL bumps whenever a device is plugged in or removed; None if unsupported."""
+    if not sdk_initialized_successfully or not hasattr(decklink_dll, "GetDeviceCatalogGeneration"):
+        return None
+    generation = ctypes.c_uint(0)
+    if decklink_dll.GetDeviceCatalogGeneration(ctypes.byref(generation)) != S_OK:
+        return None
+    return generation.value
+
+def initialize_selected_devices(fill_device_idx: int, key_device_idx: int, video_mode_details: dict, output_options: dict = None) -> bool:
+    """
+    Initializes the fill/key output pair. output_options carries optional DLL settings
+    (see make_output_config); they need a DLL with InitializeDeviceEx and are ignored otherwise.
+    """
+    global decklink_initialized_successfully, g_active_width, g_active_height, g_zero_copy_unavailable
     if not sdk_initialized_successfully:
         print("SDK not initialized. Cannot initialize devices.", file=sys.stderr)
         return False
-    
-    if len(g_device_names) < 2: # Use global g_device_names
+
+    internal_keying = (output_options or {}).get("keying_mode") == "internal"
+    if internal_keying:
+        key_device_idx = -1 # Only the fill device is opened
+        if not hasattr(decklink_dll, "InitializeDeviceEx"):
+            print("Error: Internal keying needs a DLL with InitializeDeviceEx.", file=sys.stderr)
+            return False
+    elif len(g_device_names) < 2: # Use global g_device_names
         print("Error: Need at least 2 DeckLink devices/ports for external keying.", file=sys.stderr)
         # decklink_dll.ShutdownDLL() # Avoid shutting down entire SDK on this specific failure
 
@@ -247,14 +692,16 @@ def initialize_selected_devices(fill_device_idx: int, key_device_idx: int, video
 
     # Ensure selected indices are valid (though device_count.value < 2 check helps)
     if not (0 <= fill_device_idx < len(g_device_names) and \
-            0 <= key_device_idx < len(g_device_names) and \
-            fill_device_idx != key_device_idx):
+            (internal_keying or (0 <= key_device_idx < len(g_device_names) and fill_device_idx != key_device_idx))):
         print(f"Error: Invalid device indices selected for fill ({fill_device_idx}) and key ({key_device_idx}). Available: {len(g_device_names)}", file=sys.stderr)
         # decklink_dll.ShutdownDLL() # Avoid shutting down entire SDK on this specific failure
         return False
 
     print(f"Attempting to initialize Fill on device {fill_device_idx}: {g_device_names[fill_device_idx]}")
-    print(f"Attempting to initialize Key on device {key_device_idx}: {g_device_names[key_device_idx]}")
+    if internal_keying:
+        print("Internal keying: no Key device; the fill's alpha drives the card's keyer.")
+    else:
+        print(f"Attempting to initialize Key on device {key_device_idx}: {g_device_names[key_device_idx]}")
 
     if not hasattr(decklink_dll, "InitializeDevice") or not decklink_dll.InitializeDevice:
         print("Error: InitializeDevice function not found in DLL. Cannot initialize devices.", file=sys.stderr)
@@ -262,13 +709,23 @@ def initialize_selected_devices(fill_device_idx: int, key_device_idx: int, video
         decklink_initialized_successfully = False
         return False
 
-    hr = decklink_dll.InitializeDevice(fill_device_idx, key_device_idx, width, height, fr_num, fr_den)
+    if hasattr(decklink_dll, "InitializeDeviceEx"):
+        output_config = make_output_config(output_options)
+        hr = decklink_dll.InitializeDeviceEx(fill_device_idx, key_device_idx, width, height, fr_num, fr_den, ctypes.byref(output_config))
+    else:
+        if output_options:
+            print("Warning: DLL has no InitializeDeviceEx; output options ignored.", file=sys.stderr)
+        hr = decklink_dll.InitializeDevice(fill_device_idx, key_device_idx, width, height, fr_num, fr_den)
     
     if hr == S_OK:
-        g_active_width = width
-        g_active_height = height
+        g_active_width, g_active_height = _source_size(output_options, width, height)
+        if hasattr(decklink_dll, "GetSourceFrameSize"):
+            g_active_width, g_active_height = _read_source_size(decklink_dll.GetSourceFrameSize) or (g_active_width, g_active_height)
+        g_zero_copy_unavailable = False
         print(f"Successfully initialized Fill (Device {fill_device_idx}) and Key (Device {key_device_idx}) outputs.")
-        print(f"Outputs configured for {g_active_width}x{g_active_height} @ {fr_num}/{fr_den} FPS (Num/Den).")
+        print(f"Outputs configured for {width}x{height} @ {fr_num}/{fr_den} FPS (Num/Den).")
+        if (g_active_width, g_active_height) != (width, height):
+            print(f"Frames are submitted at {g_active_width}x{g_active_height} and scaled up by the DLL.")
         decklink_initialized_successfully = True
         return True
     else:
@@ -276,6 +733,37 @@ def initialize_selected_devices(fill_device_idx: int, key_device_idx: int, video
         decklink_initialized_successfully = False
         return False
 
+def supports_reconfigure() -> bool:
+    """True if the loaded DLL can switch an open output to another mode in place (ReconfigureOutput)."""
+    return decklink_dll is not None and hasattr(decklink_dll, "ReconfigureOutput")
+
+def reconfigure_output(video_mode_details: dict, output_options: dict = None) -> bool:
+    """Switches the initialized outputs to video_mode_details (and output_options' pixel_format)
+    without shutting them down. Queued and cached frames, cues, layers of another size and the
+    video overlay are dropped; send a new frame afterwards. Refused while input capture runs or a
+    frame is acquired. False on failure, with the previous mode still on air where possible.
+    Frames are then submitted at the size the DLL reports: output_options' source size if it fits
+    the new mode, else the mode's."""
+    global g_active_width, g_active_height, g_zero_copy_unavailable
+    if not decklink_dll or not decklink_initialized_successfully or not supports_reconfigure() or not video_mode_details:
+        return False
+    width = video_mode_details.get("width")
+    height = video_mode_details.get("height")
+    pixel_format = OUTPUT_PIXEL_FORMATS.get((output_options or {}).get("pixel_format", "bgra"), OUTPUT_PIXEL_FORMAT_BGRA)
+    hr = decklink_dll.ReconfigureOutput(width, height, video_mode_details.get("fr_num"), video_mode_details.get("fr_den"), pixel_format)
+    if hr not in (S_OK, S_FALSE): # S_FALSE: already in that mode
+        print(f"ReconfigureOutput failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    source_size = _read_source_size(decklink_dll.GetSourceFrameSize)
+    if source_size is None:
+        print("ReconfigureOutput succeeded but GetSourceFrameSize failed; frames cannot be sized.", file=sys.stderr)
+        g_active_width = g_active_height = 0 # Every send is refused until the size is known
+        return False
+    g_active_width, g_active_height = source_size
+    g_zero_copy_unavailable = False
+    print(f"Outputs reconfigured for {width}x{height} @ {video_mode_details.get('fr_num')}/{video_mode_details.get('fr_den')} FPS (Num/Den).")
+    return True
+
 def shutdown_selected_devices():
     """Shuts down the currently initialized DeckLink devices."""
     global decklink_initialized_successfully, g_active_width, g_active_height
@@ -326,6 +814,10 @@ def shutdown_sdk():
 
 
 
+def supports_native_binding() -> bool:
+    """True if frames go to the DLL through decklink_native: no ctypes copies, any buffer object."""
+    return native_bound
+
 def send_external_keying_frames(fill_bgra_bytes, key_bgra_bytes):
     if not decklink_dll or not decklink_initialized_successfully:
         print("Cannot send frames: DeckLink not initialized.", file=sys.stderr)
@@ -347,15 +839,842 @@ def send_external_keying_frames(fill_bgra_bytes, key_bgra_bytes):
         print(f"Error: Key frame size mismatch. Expected {expected_frame_size} bytes, got {len(key_bgra_bytes)} bytes.", file=sys.stderr)
         return False
 
+    if native_bound:
+        hr = decklink_native.update_external_keying_frames(fill_bgra_bytes, key_bgra_bytes)
+    else:
+        c_fill_data = (ctypes.c_ubyte * len(fill_bgra_bytes)).from_buffer_copy(fill_bgra_bytes)
+        c_key_data = (ctypes.c_ubyte * len(key_bgra_bytes)).from_buffer_copy(key_bgra_bytes)
+        hr = decklink_dll.UpdateExternalKeyingFrames(c_fill_data, c_key_data)
+    if hr != S_OK and hr != S_FALSE: # S_FALSE: unchanged frame, nothing needed sending
+        print(f"UpdateExternalKeyingFrames failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def send_external_keying_frames_dirty(fill_bgra_bytes, key_bgra_bytes, dirty_rects):
+    """
+    Like send_external_keying_frames, but only the regions in dirty_rects (QRects changed since the
+    previous frame) are compared and copied. key_bgra_bytes may be None to derive the key from alpha.
+    """
+    if not decklink_dll or not decklink_initialized_successfully:
+        print("Cannot send frames: DeckLink not initialized.", file=sys.stderr)
+        return False
+    if not hasattr(decklink_dll, "UpdateExternalKeyingFramesDirty"):
+        print("Error: UpdateExternalKeyingFramesDirty function not found in DLL.", file=sys.stderr)
+        return False
+
+    expected_frame_size = g_active_width * g_active_height * 4
+    if len(fill_bgra_bytes) != expected_frame_size or (key_bgra_bytes is not None and len(key_bgra_bytes) != expected_frame_size):
+        print(f"Error: Frame size mismatch. Expected {expected_frame_size} bytes per frame.", file=sys.stderr)
+        return False
+
     c_fill_data = (ctypes.c_ubyte * len(fill_bgra_bytes)).from_buffer_copy(fill_bgra_bytes)
-    c_key_data = (ctypes.c_ubyte * len(key_bgra_bytes)).from_buffer_copy(key_bgra_bytes)
-    
-    hr = decklink_dll.UpdateExternalKeyingFrames(c_fill_data, c_key_data)
+    c_key_data = (ctypes.c_ubyte * len(key_bgra_bytes)).from_buffer_copy(key_bgra_bytes) if key_bgra_bytes is not None else None
+    c_rects = (DeckLinkDirtyRect * max(1, len(dirty_rects)))()
+    for i, rect in enumerate(dirty_rects):
+        c_rects[i] = DeckLinkDirtyRect(rect.x(), rect.y(), rect.width(), rect.height())
+
+    hr = decklink_dll.UpdateExternalKeyingFramesDirty(c_fill_data, c_key_data, c_rects, len(dirty_rects))
+    if hr != S_OK and hr != S_FALSE:
+        print(f"UpdateExternalKeyingFramesDirty failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def get_skipped_frame_count() -> int:
+    """Number of updates the DLL elided because the frame had not changed (-1 if unavailable)."""
+    if not decklink_dll or not hasattr(decklink_dll, "GetSkippedFrameCount"):
+        return -1
+    count = ctypes.c_ulonglong(0)
+    if decklink_dll.GetSkippedFrameCount(ctypes.byref(count)) != S_OK:
+        return -1
+    return count.value
+
+def get_output_stats():
+    """
+    Snapshot of the DLL's output health counters as a dict keyed by the DeckLinkOutputStats field
+    names (frame counts, submit-to-display latency and copy time in ms). None if unavailable.
+    """
+    if not decklink_dll or not hasattr(decklink_dll, "GetOutputStats"):
+        return None
+    stats = DeckLinkOutputStats()
+    stats.structSize = ctypes.sizeof(DeckLinkOutputStats)
+    hr = decklink_dll.GetOutputStats(ctypes.byref(stats))
     if hr != S_OK:
-        print(f"UpdateExternalKeyingFrames failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        print(f"GetOutputStats failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+    return {name: getattr(stats, name) for name, _ in DeckLinkOutputStats._fields_ if name != "structSize"}
+
+def get_reference_status():
+    """Genlock state of the output: "locked", "unlocked" or "not_supported"; None if unavailable.
+    With get_output_stats()["bufferedVideoFrames"] and ["prerollFrames"] this is what to watch
+    when tuning preroll_frames / latency_profile."""
+    if not decklink_dll or not decklink_initialized_successfully or not hasattr(decklink_dll, "GetReferenceStatus"):
+        return None
+    status = ctypes.c_int(0)
+    if decklink_dll.GetReferenceStatus(ctypes.byref(status)) != S_OK:
+        return None
+    return REFERENCE_STATUS_NAMES.get(status.value)
+
+def supports_zero_copy_frames() -> bool:
+    """True if the loaded DLL can hand out pooled frame memory for in-place rendering."""
+    return (decklink_dll is not None and not g_zero_copy_unavailable and
+            hasattr(decklink_dll, "AcquireFillKeyFrame") and
+            hasattr(decklink_dll, "CommitFillKeyFrame") and
+            hasattr(decklink_dll, "CancelFillKeyFrame"))
+
+def acquire_fill_key_frame():
+    """
+    Acquires a pooled fill/key frame pair inside the DLL and wraps its memory as QImages
+    (Format_ARGB32_Premultiplied, which is BGRA in memory). Paint the whole frame into both
+    images, then call commit_fill_key_frame(). The images must not be used after commit/cancel.
+    Returns: (fill_qimage, key_qimage) or (None, None) if unavailable.
+    """
+    global g_acquired_frame_buffers, g_zero_copy_unavailable
+    if not decklink_dll or not decklink_initialized_successfully:
+        print("Cannot acquire frame: DeckLink not initialized.", file=sys.stderr)
+        return None, None
+    if not supports_zero_copy_frames():
+        return None, None
+    if g_active_width == 0 or g_active_height == 0:
+        print("Error: DeckLink active dimensions not set (or zero). Initialize device first with valid dimensions.", file=sys.stderr)
+        return None, None
+
+    fill_ptr = ctypes.c_void_p()
+    key_ptr = ctypes.c_void_p()
+    row_bytes = ctypes.c_long(0)
+    hr = decklink_dll.AcquireFillKeyFrame(ctypes.byref(fill_ptr), ctypes.byref(key_ptr), ctypes.byref(row_bytes))
+    if (hr & 0xFFFFFFFF) == E_NOTIMPL:
+        # Output frames are YUV; stay on the copy-in path until the device is reinitialized
+        g_zero_copy_unavailable = True
+        return None, None
+    if hr != S_OK:
+        print(f"AcquireFillKeyFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None, None
+
+    # Wrap the DLL's memory without copying; QImage paints straight into the DeckLink frames.
+    buffer_size = row_bytes.value * g_active_height
+    fill_buffer = (ctypes.c_ubyte * buffer_size).from_address(fill_ptr.value)
+    key_buffer = (ctypes.c_ubyte * buffer_size).from_address(key_ptr.value) if key_ptr.value else None # None with internal keying
+    g_acquired_frame_buffers = (fill_buffer, key_buffer)
+
+    fill_image = QImage(fill_buffer, g_active_width, g_active_height, row_bytes.value, QImage.Format_ARGB32_Premultiplied)
+    key_image = QImage(key_buffer, g_active_width, g_active_height, row_bytes.value, QImage.Format_ARGB32_Premultiplied) if key_buffer is not None else None
+    return fill_image, key_image
+
+def commit_fill_key_frame():
+    """Schedules the frame pair obtained from acquire_fill_key_frame()."""
+    global g_acquired_frame_buffers
+    if not decklink_dll or not supports_zero_copy_frames():
+        return False
+    hr = decklink_dll.CommitFillKeyFrame()
+    g_acquired_frame_buffers = None
+    if hr != S_OK and hr != S_FALSE: # S_FALSE: unchanged frame, nothing needed sending
+        print(f"CommitFillKeyFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def cancel_fill_key_frame():
+    """Returns the frame pair obtained from acquire_fill_key_frame() to the pool unused."""
+    global g_acquired_frame_buffers
+    if not decklink_dll or not supports_zero_copy_frames():
+        return False
+    hr = decklink_dll.CancelFillKeyFrame()
+    g_acquired_frame_buffers = None
+    return hr == S_OK or hr == S_FALSE # S_FALSE: nothing was acquired
+
+def supports_native_key_matte() -> bool:
+    """True if the loaded DLL can generate the key signal from the fill's alpha channel."""
+    return (decklink_dll is not None and
+            hasattr(decklink_dll, "UpdateFillAutoKey") and
+            hasattr(decklink_dll, "CommitFillFrameAutoKey"))
+
+def send_fill_frame_auto_key(fill_bgra_bytes):
+    """Sends a premultiplied BGRA fill frame; the key (alpha as greyscale) is generated in the DLL."""
+    if not decklink_dll or not decklink_initialized_successfully:
+        print("Cannot send frames: DeckLink not initialized.", file=sys.stderr)
+        return False
+    if not supports_native_key_matte():
+        print("Error: UpdateFillAutoKey function not found in DLL.", file=sys.stderr)
+        return False
+    if g_active_width == 0 or g_active_height == 0:
+        print("Error: DeckLink active dimensions not set (or zero). Initialize device first with valid dimensions.", file=sys.stderr)
+        return False
+
+    expected_frame_size = g_active_width * g_active_height * 4
+    if len(fill_bgra_bytes) != expected_frame_size:
+        print(f"Error: Fill frame size mismatch. Expected {expected_frame_size} bytes, got {len(fill_bgra_bytes)} bytes.", file=sys.stderr)
+        return False
+
+    if native_bound:
+        hr = decklink_native.update_fill_auto_key(fill_bgra_bytes)
+    else:
+        c_fill_data = (ctypes.c_ubyte * len(fill_bgra_bytes)).from_buffer_copy(fill_bgra_bytes)
+        hr = decklink_dll.UpdateFillAutoKey(c_fill_data)
+    if hr != S_OK and hr != S_FALSE: # S_FALSE: unchanged frame, nothing needed sending
+        print(f"UpdateFillAutoKey failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def commit_fill_frame_auto_key():
+    """Schedules a frame from acquire_fill_key_frame() where only the fill image was painted."""
+    global g_acquired_frame_buffers
+    if not decklink_dll or not supports_native_key_matte():
+        return False
+    hr = decklink_dll.CommitFillFrameAutoKey()
+    g_acquired_frame_buffers = None
+    if hr != S_OK and hr != S_FALSE: # S_FALSE: unchanged frame, nothing needed sending
+        print(f"CommitFillFrameAutoKey failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+
+def supports_frame_queue() -> bool:
+    """True if the loaded DLL has the asynchronous submit queue (EnqueueFillKeyFrame)."""
+    return decklink_dll is not None and hasattr(decklink_dll, "EnqueueFillKeyFrame")
+
+def _qimage_buffer(q_image: QImage, width: int = None, height: int = None):
+    """
+    ctypes view over a QImage's pixels (no copy), or None if it is not a full-size BGRA frame.
+    width/height default to the InitializeDevice output's size.
+    """
+    width = g_active_width if width is None else width
+    height = g_active_height if height is None else height
+    if (q_image is None or q_image.isNull() or q_image.format() != QImage.Format_ARGB32_Premultiplied or
+            q_image.width() != width or q_image.height() != height or
+            q_image.bytesPerLine() != width * 4):
+        return None
+    return (ctypes.c_ubyte * (width * height * 4)).from_buffer(q_image.bits())
+
+def enqueue_fill_key_frame(fill_image: QImage, key_image: QImage = None):
+    """
+    Hands a premultiplied BGRA frame to the DLL's output thread and returns without waiting for the card.
+    The DLL copies the pixels before returning, so the images can be reused at once.
+    key_image may be None to derive the key from the fill's alpha.
+    """
+    if not decklink_dll or not decklink_initialized_successfully:
+        print("Cannot send frames: DeckLink not initialized.", file=sys.stderr)
+        return False
+    if not supports_frame_queue():
+        print("Error: EnqueueFillKeyFrame function not found in DLL.", file=sys.stderr)
+        return False
+
+    c_fill_data = _qimage_buffer(fill_image)
+    c_key_data = _qimage_buffer(key_image) if key_image is not None else None
+    if c_fill_data is None or (key_image is not None and c_key_data is None):
+        print(f"Error: Frames must be {g_active_width}x{g_active_height} ARGB32_Premultiplied images.", file=sys.stderr)
+        return False
+
+    hr = decklink_dll.EnqueueFillKeyFrame(c_fill_data, c_key_data)
+    if hr != S_OK:
+        print(f"EnqueueFillKeyFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+# --- Frame Cache ---
+# cache_frame converts a finished frame into DLL-side DeckLink frames ahead of time; take_cached_frame
+# then cuts to it with one call that moves no pixels. Least recently used frames are dropped once the
+# output's frame_cache_mb budget is used up, so a take may miss and the caller sends the frame instead.
+
+def supports_frame_cache() -> bool:
+    """True if the loaded DLL has CacheFrame/TakeCachedFrame."""
+    return decklink_dll is not None and hasattr(decklink_dll, "TakeCachedFrame")
+
+def cache_frame(frame_id: int, fill_image: QImage, key_image: QImage = None) -> bool:
+    """Stores a full-size premultiplied BGRA frame under frame_id, replacing any frame with that id. key_image None derives the key."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_frame_cache():
+        return False
+    c_fill_data = _qimage_buffer(fill_image)
+    c_key_data = _qimage_buffer(key_image) if key_image is not None else None
+    if c_fill_data is None or (key_image is not None and c_key_data is None):
+        return False
+    hr = decklink_dll.CacheFrame(frame_id, c_fill_data, c_key_data)
+    if hr != S_OK:
+        print(f"CacheFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def take_cached_frame(frame_id: int) -> bool:
+    """Puts a cached frame on air. False if it is not cached (any more) or the take failed."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_frame_cache():
+        return False
+    hr = decklink_dll.TakeCachedFrame(frame_id)
+    if hr != S_OK:
+        if (hr & 0xFFFFFFFF) != E_INVALIDARG: # A miss is expected after eviction
+            print(f"TakeCachedFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def evict_frame(frame_id: int):
+    if decklink_dll and supports_frame_cache():
+        decklink_dll.EvictFrame(frame_id)
+
+# --- Video Layer ---
+# A video background skips Qt: FFmpeg frames go to enqueue_video_frame from the decode thread and the
+# DLL's output thread draws the overlay (the rest of the scene) over each one. Do not also send frames
+# with enqueue_fill_key_frame while a video is feeding the output.
+
+def supports_video_layer() -> bool:
+    """True if the loaded DLL has SetVideoOverlay/EnqueueVideoFrame."""
+    return decklink_dll is not None and hasattr(decklink_dll, "EnqueueVideoFrame")
+
+def set_video_overlay(overlay_image: QImage) -> bool:
+    """Sets the full-size premultiplied BGRA overlay drawn over every video frame; None removes it."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_video_layer():
+        return False
+    c_overlay_data = _qimage_buffer(overlay_image) if overlay_image is not None else None
+    if overlay_image is not None and c_overlay_data is None:
+        print("Error: The video overlay must be a full-size ARGB32_Premultiplied image.", file=sys.stderr)
+        return False
+    hr = decklink_dll.SetVideoOverlay(c_overlay_data)
+    if hr != S_OK:
+        print(f"SetVideoOverlay failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def enqueue_video_frame(frame_bytes: bytes) -> bool:
+    """Queues one decoded full-size BGRA video frame (alpha 255). Safe to call from a decode thread."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_video_layer():
+        return False
+    expected_frame_size = g_active_width * g_active_height * 4
+    if len(frame_bytes) != expected_frame_size:
+        return False
+    if native_bound:
+        hr = decklink_native.enqueue_video_frame(frame_bytes)
+    else:
+        c_frame_data = ctypes.cast(ctypes.c_char_p(frame_bytes), ctypes.POINTER(ctypes.c_ubyte)) # No copy; the DLL copies
+        hr = decklink_dll.EnqueueVideoFrame(c_frame_data)
+    if hr != S_OK:
+        print(f"EnqueueVideoFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
         return False
     return True
 
+def supports_transitions() -> bool:
+    """True if the loaded DLL can run transitions between cached frames."""
+    return decklink_dll is not None and hasattr(decklink_dll, "StartTransition")
+
+def start_transition(from_id: int, to_id: int, transition: str, duration_frames: int) -> bool:
+    """Runs a dissolve or wipe from one cached frame to another and returns at once; the DLL
+    schedules every frame, ending on to_id. False if either frame is not cached (any more)."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_transitions():
+        return False
+    transition_type = TRANSITION_TYPES.get(transition)
+    if transition_type is None:
+        print(f"Unknown transition '{transition}'.", file=sys.stderr)
+        return False
+    hr = decklink_dll.StartTransition(from_id, to_id, transition_type, duration_frames)
+    if hr != S_OK:
+        if (hr & 0xFFFFFFFF) != E_INVALIDARG:
+            print(f"StartTransition failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+# --- Cued Takes ---
+# A cue puts a frame on air at an exact frame of the card's stream clock instead of whenever the
+# call gets through: read get_stream_time() and cue for earliestCueTime plus a whole number of
+# frameDuration. A cue before earliestCueTime is taken at the next free frame instead. One cue is
+# pending at a time; frames sent meanwhile still go out until it lands.
+
+def supports_cued_takes() -> bool:
+    """True if the loaded DLL has CueFrame/GetStreamTime."""
+    return decklink_dll is not None and hasattr(decklink_dll, "GetStreamTime")
+
+def _read_stream_time(read, *args):
+    stream_time = DeckLinkStreamTime()
+    stream_time.structSize = ctypes.sizeof(DeckLinkStreamTime)
+    if read(*args, ctypes.byref(stream_time)) != S_OK:
+        return None
+    return {name: getattr(stream_time, name) for name, _ in DeckLinkStreamTime._fields_ if name != "structSize"}
+
+def get_stream_time():
+    """The output's stream clock as a dict keyed by the DeckLinkStreamTime field names (times in
+    timeScale units; running is 0 until the first frame was sent). None if unavailable."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_cued_takes():
+        return None
+    return _read_stream_time(decklink_dll.GetStreamTime)
+
+def _report_cue(name: str, hr) -> bool:
+    if hr == S_FALSE:
+        print(f"{name}: the cued frame was already queued; taken at the next free frame.", file=sys.stderr)
+    elif hr != S_OK:
+        if (hr & 0xFFFFFFFF) != E_INVALIDARG: # Not cached (any more)
+            print(f"{name} failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def cue_frame(fill_image: QImage, stream_time: int, key_image: QImage = None) -> bool:
+    """Cues a full-size premultiplied BGRA frame for the first frame at or after stream_time; the
+    DLL converts it now. key_image None derives the key."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_cued_takes():
+        return False
+    c_fill_data = _qimage_buffer(fill_image)
+    c_key_data = _qimage_buffer(key_image) if key_image is not None else None
+    if c_fill_data is None or (key_image is not None and c_key_data is None):
+        print(f"Error: Frames must be {g_active_width}x{g_active_height} ARGB32_Premultiplied images.", file=sys.stderr)
+        return False
+    return _report_cue("CueFrame", decklink_dll.CueFrame(c_fill_data, c_key_data, stream_time))
+
+def cue_cached_frame(frame_id: int, stream_time: int) -> bool:
+    """Cues a cached frame; False if it is not cached (any more)."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_cued_takes():
+        return False
+    return _report_cue("CueCachedFrame", decklink_dll.CueCachedFrame(frame_id, stream_time))
+
+def cancel_cue():
+    if decklink_dll and supports_cued_takes():
+        decklink_dll.CancelCue()
+
+# --- Layers ---
+# The DLL keeps a stack of premultiplied BGRA layers (lowest id at the bottom) and composes them on
+# its output thread at present_layers, deriving the key from the result. A background is set once;
+# a lyric change sends only its text layer. Transparent rows are dropped as a layer is set, so a
+# full-frame text render costs only its text band.
+
+def supports_layers() -> bool:
+    """True if the loaded DLL has the layer compositor."""
+    return decklink_dll is not None and hasattr(decklink_dll, "PresentLayers")
+
+def _layer_args(layer_image: QImage):
+    """(pixels, width, height) for SetLayer; pixels is None if the image cannot be a layer."""
+    if layer_image is None:
+        return None, 0, 0
+    return _qimage_buffer(layer_image, layer_image.width(), layer_image.height()), layer_image.width(), layer_image.height()
+
+def set_layer(layer_id: int, layer_image: QImage, x: int = 0, y: int = 0, opacity: int = 255) -> bool:
+    """Sets layer layer_id to an ARGB32_Premultiplied image placed at (x, y), faded to opacity
+    (0..255); the DLL keeps a copy. None removes the layer. Shown at the next present_layers."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_layers():
+        return False
+    c_layer_data, width, height = _layer_args(layer_image)
+    if layer_image is not None and c_layer_data is None:
+        print("Error: A layer must be an ARGB32_Premultiplied image.", file=sys.stderr)
+        return False
+    hr = decklink_dll.SetLayer(layer_id, c_layer_data, width, height, x, y, opacity)
+    if hr != S_OK:
+        print(f"SetLayer failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def set_layer_placement(layer_id: int, x: int, y: int, opacity: int = 255) -> bool:
+    """Moves or fades a layer without sending its pixels again."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_layers():
+        return False
+    return decklink_dll.SetLayerPlacement(layer_id, x, y, opacity) == S_OK
+
+def clear_layers():
+    if decklink_dll and supports_layers():
+        decklink_dll.ClearLayers()
+
+def present_layers() -> bool:
+    """Queues a frame composed from the layers and returns without waiting for the card."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_layers():
+        return False
+    hr = decklink_dll.PresentLayers()
+    if hr != S_OK:
+        print(f"PresentLayers failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+# --- Shared Textures ---
+# A renderer drawing with D3D11 hands the DLL a shared texture handle instead of pixels: the DLL
+# queues a GPU copy and reads it back on its output thread, so the frame is never mapped in Python.
+# The texture must be full-size, single-sampled, premultiplied B8G8R8A8 on the default adapter.
+
+def supports_shared_textures() -> bool:
+    """True if the loaded DLL accepts shared D3D11 textures."""
+    return decklink_dll is not None and hasattr(decklink_dll, "EnqueueSharedTexture")
+
+def _keyed_mutex_args(keyed_mutex_keys):
+    if keyed_mutex_keys is None:
+        return 0, 0, 0
+    acquire_key, release_key = keyed_mutex_keys
+    return 1, acquire_key, release_key
+
+def enqueue_shared_texture(shared_handle: int, keyed_mutex_keys=None) -> bool:
+    """Queues the texture behind shared_handle (GetSharedHandle or CreateSharedHandle). Pass
+    keyed_mutex_keys=(acquire_key, release_key) if the texture has a keyed mutex; the DLL holds it
+    only while queueing the copy. The key is derived from the texture's alpha."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_shared_textures():
+        return False
+    if not shared_handle:
+        return False
+    hr = decklink_dll.EnqueueSharedTexture(ctypes.c_void_p(shared_handle), *_keyed_mutex_args(keyed_mutex_keys))
+    if hr != S_OK:
+        print(f"EnqueueSharedTexture failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+# --- Input Capture ---
+# A live DeckLink input as the background: the DLL captures it in the output's display mode and
+# draws the video overlay (set_video_overlay) over every captured frame, so the feed never passes
+# through Python. Frames sent with enqueue_fill_key_frame are refused while capture runs.
+
+def supports_input_capture() -> bool:
+    """True if the loaded DLL can capture a DeckLink input under the video overlay."""
+    return decklink_dll is not None and hasattr(decklink_dll, "StartInputCapture")
+
+def start_input_capture(device_index: int) -> bool:
+    """Starts capturing from device_index (a get_device_count index) in the output's display mode."""
+    if not decklink_dll or not decklink_initialized_successfully or not supports_input_capture():
+        return False
+    hr = decklink_dll.StartInputCapture(device_index)
+    if hr != S_OK:
+        print(f"StartInputCapture failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def stop_input_capture():
+    if decklink_dll and supports_input_capture():
+        decklink_dll.StopInputCapture()
+
+def _read_input_stats(read, *args):
+    stats = DeckLinkInputStats()
+    stats.structSize = ctypes.sizeof(DeckLinkInputStats)
+    if read(*args, ctypes.byref(stats)) != S_OK:
+        return None
+    return {name: getattr(stats, name) for name, _ in DeckLinkInputStats._fields_ if name != "structSize"}
+
+def get_input_capture_stats():
+    """Capture counters (frames captured, without signal, rejected) as a dict; None if unavailable."""
+    if not decklink_dll or not supports_input_capture():
+        return None
+    return _read_input_stats(decklink_dll.GetInputCaptureStats)
+
+# --- Thumbnails ---
+# The slide grid shrinks every full-size render to a preview. DownsampleBatch box-filters a whole
+# batch in one call on the DLL's worker threads, with the GIL released, and needs no DeckLink device;
+# the DLL is loaded on first use if no output has loaded it yet.
+
+_thumbnail_dll_load_attempted = False
+
+def supports_downsample_batch() -> bool:
+    """True if the loaded DLL has the batched thumbnail downsampler."""
+    return decklink_dll is not None and hasattr(decklink_dll, "DownsampleBatch")
+
+def _image_descriptor(q_image: QImage) -> DeckLinkImage:
+    data = (ctypes.c_ubyte * q_image.sizeInBytes()).from_buffer(q_image.bits())
+    return DeckLinkImage(ctypes.cast(data, ctypes.POINTER(ctypes.c_ubyte)), q_image.width(), q_image.height(), q_image.bytesPerLine())
+
+def downsample_images(images, sizes, threads: int = 0):
+    """
+    Area-filters each QImage down to the matching (width, height) in sizes, which must be no larger
+    than the source. Returns a list of ARGB32_Premultiplied QImages, or None (DLL unavailable or a
+    size rejected) so the caller can fall back to QImage.scaled. threads=0 lets the DLL choose.
+    """
+    global _thumbnail_dll_load_attempted
+    if decklink_dll is None and not _thumbnail_dll_load_attempted:
+        _thumbnail_dll_load_attempted = True
+        load_dll()
+    if not supports_downsample_batch() or len(images) != len(sizes):
+        return None
+    if not images:
+        return []
+    sources = [image if image.format() == QImage.Format_ARGB32_Premultiplied
+               else image.convertToFormat(QImage.Format_ARGB32_Premultiplied) for image in images]
+    results = [QImage(width, height, QImage.Format_ARGB32_Premultiplied) for width, height in sizes]
+    count = len(sources)
+    src_array = (DeckLinkImage * count)(*[_image_descriptor(image) for image in sources])
+    dst_array = (DeckLinkImage * count)(*[_image_descriptor(image) for image in results])
+    hr = decklink_dll.DownsampleBatch(src_array, count, dst_array, threads)
+    if hr != S_OK:
+        print(f"DownsampleBatch failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+    return results
+
+# --- Output Handles ---
+# create_output opens an extra fill/key pair next to the one InitializeDevice drives. Each has its
+# own frame pool, submit queue and output thread in the DLL, so several pairs run without waiting
+# on each other.
+class DeckLinkOutput:
+    """A fill/key pair opened with create_output; pass it to the *_output functions. width and
+    height are the size its frames are submitted at."""
+    def __init__(self, handle: DeckLinkOutputHandle, width: int, height: int):
+        self.handle = handle
+        self.width = width
+        self.height = height
+
+def supports_output_handles() -> bool:
+    """True if the loaded DLL can open several independent outputs (CreateOutput)."""
+    return decklink_dll is not None and hasattr(decklink_dll, "CreateOutput")
+
+def create_output(fill_device_idx: int, key_device_idx: int, video_mode_details: dict, output_options: dict = None):
+    """Opens a fill/key pair as its own output. Returns a DeckLinkOutput, or None on failure."""
+    if not sdk_initialized_successfully or not supports_output_handles():
+        print("Cannot create output: SDK not initialized or DLL has no CreateOutput.", file=sys.stderr)
+        return None
+    width = video_mode_details.get("width")
+    height = video_mode_details.get("height")
+    output_config = make_output_config(output_options)
+    handle = DeckLinkOutputHandle()
+    hr = decklink_dll.CreateOutput(fill_device_idx, key_device_idx, width, height,
+                                   video_mode_details.get("fr_num"), video_mode_details.get("fr_den"),
+                                   ctypes.byref(output_config), ctypes.byref(handle))
+    if hr != S_OK or not handle.value:
+        print(f"CreateOutput failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+    source_size = _source_size(output_options, width, height)
+    if hasattr(decklink_dll, "GetOutputSourceFrameSize"):
+        source_size = _read_source_size(decklink_dll.GetOutputSourceFrameSize, handle) or source_size
+    return DeckLinkOutput(handle, *source_size)
+
+def destroy_output(output: DeckLinkOutput) -> bool:
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    hr = decklink_dll.DestroyOutput(output.handle)
+    output.handle = None
+    if hr != S_OK:
+        print(f"DestroyOutput failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def _output_frame_buffers(output: DeckLinkOutput, fill_image: QImage, key_image: QImage):
+    c_fill_data = _qimage_buffer(fill_image, output.width, output.height)
+    c_key_data = _qimage_buffer(key_image, output.width, output.height) if key_image is not None else None
+    if c_fill_data is None or (key_image is not None and c_key_data is None):
+        print(f"Error: Frames must be {output.width}x{output.height} ARGB32_Premultiplied images.", file=sys.stderr)
+        return None
+    return c_fill_data, c_key_data
+
+def update_output_frames(output: DeckLinkOutput, fill_image: QImage, key_image: QImage = None):
+    """Copy-in update of one output; key_image may be None to derive the key from the fill's alpha."""
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    buffers = _output_frame_buffers(output, fill_image, key_image)
+    if buffers is None:
+        return False
+    hr = decklink_dll.UpdateFrames(output.handle, *buffers)
+    if hr not in (S_OK, S_FALSE): # S_FALSE: frame unchanged, nothing was sent
+        print(f"UpdateFrames failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def enqueue_output_frames(output: DeckLinkOutput, fill_image: QImage, key_image: QImage = None):
+    """Asynchronous update of one output, like enqueue_fill_key_frame."""
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    buffers = _output_frame_buffers(output, fill_image, key_image)
+    if buffers is None:
+        return False
+    hr = decklink_dll.EnqueueFrames(output.handle, *buffers)
+    if hr != S_OK:
+        print(f"EnqueueFrames failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def cache_output_frame(output: DeckLinkOutput, frame_id: int, fill_image: QImage, key_image: QImage = None) -> bool:
+    """cache_frame for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    buffers = _output_frame_buffers(output, fill_image, key_image)
+    if buffers is None:
+        return False
+    hr = decklink_dll.CacheOutputFrame(output.handle, frame_id, *buffers)
+    if hr != S_OK:
+        print(f"CacheOutputFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def take_output_cached_frame(output: DeckLinkOutput, frame_id: int) -> bool:
+    """take_cached_frame for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    hr = decklink_dll.TakeOutputCachedFrame(output.handle, frame_id)
+    if hr != S_OK:
+        if (hr & 0xFFFFFFFF) != E_INVALIDARG:
+            print(f"TakeOutputCachedFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def evict_output_frame(output: DeckLinkOutput, frame_id: int):
+    if decklink_dll and output is not None and output.handle is not None:
+        decklink_dll.EvictOutputFrame(output.handle, frame_id)
+
+def set_output_video_overlay(output: DeckLinkOutput, overlay_image: QImage) -> bool:
+    """set_video_overlay for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "SetOutputVideoOverlay"):
+        return False
+    c_overlay_data = _qimage_buffer(overlay_image, output.width, output.height) if overlay_image is not None else None
+    if overlay_image is not None and c_overlay_data is None:
+        return False
+    hr = decklink_dll.SetOutputVideoOverlay(output.handle, c_overlay_data)
+    if hr != S_OK:
+        print(f"SetOutputVideoOverlay failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def set_output_layer(output: DeckLinkOutput, layer_id: int, layer_image: QImage, x: int = 0, y: int = 0, opacity: int = 255) -> bool:
+    """set_layer for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "SetOutputLayer"):
+        return False
+    c_layer_data, width, height = _layer_args(layer_image)
+    if layer_image is not None and c_layer_data is None:
+        return False
+    hr = decklink_dll.SetOutputLayer(output.handle, layer_id, c_layer_data, width, height, x, y, opacity)
+    if hr != S_OK:
+        print(f"SetOutputLayer failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def set_output_layer_placement(output: DeckLinkOutput, layer_id: int, x: int, y: int, opacity: int = 255) -> bool:
+    """set_layer_placement for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "SetOutputLayerPlacement"):
+        return False
+    return decklink_dll.SetOutputLayerPlacement(output.handle, layer_id, x, y, opacity) == S_OK
+
+def clear_output_layers(output: DeckLinkOutput):
+    if decklink_dll and output is not None and output.handle is not None and hasattr(decklink_dll, "ClearOutputLayers"):
+        decklink_dll.ClearOutputLayers(output.handle)
+
+def present_output_layers(output: DeckLinkOutput) -> bool:
+    """present_layers for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "PresentOutputLayers"):
+        return False
+    hr = decklink_dll.PresentOutputLayers(output.handle)
+    if hr != S_OK:
+        print(f"PresentOutputLayers failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def enqueue_output_video_frame(output: DeckLinkOutput, frame_bytes: bytes) -> bool:
+    """enqueue_video_frame for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "EnqueueOutputVideoFrame"):
+        return False
+    if len(frame_bytes) != output.width * output.height * 4:
+        return False
+    c_frame_data = ctypes.cast(ctypes.c_char_p(frame_bytes), ctypes.POINTER(ctypes.c_ubyte))
+    hr = decklink_dll.EnqueueOutputVideoFrame(output.handle, c_frame_data)
+    if hr != S_OK:
+        print(f"EnqueueOutputVideoFrame failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def enqueue_output_shared_texture(output: DeckLinkOutput, shared_handle: int, keyed_mutex_keys=None) -> bool:
+    """enqueue_shared_texture for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "EnqueueOutputSharedTexture"):
+        return False
+    if not shared_handle:
+        return False
+    hr = decklink_dll.EnqueueOutputSharedTexture(output.handle, ctypes.c_void_p(shared_handle), *_keyed_mutex_args(keyed_mutex_keys))
+    if hr != S_OK:
+        print(f"EnqueueOutputSharedTexture failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def start_output_transition(output: DeckLinkOutput, from_id: int, to_id: int, transition: str, duration_frames: int) -> bool:
+    """start_transition for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "StartOutputTransition"):
+        return False
+    transition_type = TRANSITION_TYPES.get(transition)
+    if transition_type is None:
+        return False
+    hr = decklink_dll.StartOutputTransition(output.handle, from_id, to_id, transition_type, duration_frames)
+    if hr != S_OK:
+        if (hr & 0xFFFFFFFF) != E_INVALIDARG:
+            print(f"StartOutputTransition failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def get_output_stream_time(output: DeckLinkOutput):
+    """get_stream_time for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "GetOutputStreamTime"):
+        return None
+    return _read_stream_time(decklink_dll.GetOutputStreamTime, output.handle)
+
+def cue_output_frame(output: DeckLinkOutput, fill_image: QImage, stream_time: int, key_image: QImage = None) -> bool:
+    """cue_frame for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "CueOutputFrame"):
+        return False
+    buffers = _output_frame_buffers(output, fill_image, key_image)
+    if buffers is None:
+        return False
+    return _report_cue("CueOutputFrame", decklink_dll.CueOutputFrame(output.handle, *buffers, stream_time))
+
+def cue_output_cached_frame(output: DeckLinkOutput, frame_id: int, stream_time: int) -> bool:
+    """cue_cached_frame for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "CueOutputCachedFrame"):
+        return False
+    return _report_cue("CueOutputCachedFrame", decklink_dll.CueOutputCachedFrame(output.handle, frame_id, stream_time))
+
+def cancel_output_cue(output: DeckLinkOutput):
+    if decklink_dll and output is not None and output.handle is not None and hasattr(decklink_dll, "CancelOutputCue"):
+        decklink_dll.CancelOutputCue(output.handle)
+
+def reconfigure_output_handle(output: DeckLinkOutput, video_mode_details: dict, output_options: dict = None) -> bool:
+    """reconfigure_output for an output opened with create_output; updates output.width/height."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "ReconfigureOutputByHandle"):
+        return False
+    width = video_mode_details.get("width")
+    height = video_mode_details.get("height")
+    pixel_format = OUTPUT_PIXEL_FORMATS.get((output_options or {}).get("pixel_format", "bgra"), OUTPUT_PIXEL_FORMAT_BGRA)
+    hr = decklink_dll.ReconfigureOutputByHandle(output.handle, width, height, video_mode_details.get("fr_num"),
+                                                video_mode_details.get("fr_den"), pixel_format)
+    if hr not in (S_OK, S_FALSE):
+        print(f"ReconfigureOutputByHandle failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    source_size = _read_source_size(decklink_dll.GetOutputSourceFrameSize, output.handle)
+    if source_size is None:
+        print("ReconfigureOutputByHandle succeeded but GetOutputSourceFrameSize failed; frames cannot be sized.", file=sys.stderr)
+        output.width = output.height = 0
+        return False
+    output.width, output.height = source_size
+    return True
+
+def get_output_stats_for(output: DeckLinkOutput):
+    """get_output_stats for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None:
+        return None
+    stats = DeckLinkOutputStats()
+    stats.structSize = ctypes.sizeof(DeckLinkOutputStats)
+    hr = decklink_dll.GetOutputStatsByHandle(output.handle, ctypes.byref(stats))
+    if hr != S_OK:
+        print(f"GetOutputStatsByHandle failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return None
+    return {name: getattr(stats, name) for name, _ in DeckLinkOutputStats._fields_ if name != "structSize"}
+
+def start_output_capture(output: DeckLinkOutput, device_index: int) -> bool:
+    """start_input_capture for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "StartOutputCapture"):
+        return False
+    hr = decklink_dll.StartOutputCapture(output.handle, device_index)
+    if hr != S_OK:
+        print(f"StartOutputCapture failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
+
+def stop_output_capture(output: DeckLinkOutput):
+    if decklink_dll and output is not None and output.handle is not None and hasattr(decklink_dll, "StopOutputCapture"):
+        decklink_dll.StopOutputCapture(output.handle)
+
+def get_output_capture_stats(output: DeckLinkOutput):
+    """get_input_capture_stats for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "GetOutputCaptureStats"):
+        return None
+    return _read_input_stats(decklink_dll.GetOutputCaptureStats, output.handle)
+
+def get_output_reference_status(output: DeckLinkOutput):
+    """get_reference_status for an output opened with create_output."""
+    if not decklink_dll or output is None or output.handle is None or not hasattr(decklink_dll, "GetOutputReferenceStatus"):
+        return None
+    status = ctypes.c_int(0)
+    if decklink_dll.GetOutputReferenceStatus(output.handle, ctypes.byref(status)) != S_OK:
+        return None
+    return REFERENCE_STATUS_NAMES.get(status.value)
+
+def set_output_keyer(output: DeckLinkOutput, enabled: bool, is_external: bool = True, level: int = 255) -> bool:
+    """Enables (at level) or disables the keyer of one output."""
+    if not decklink_dll or output is None or output.handle is None:
+        return False
+    if not enabled:
+        hr = decklink_dll.DisableOutputKeyer(output.handle)
+    else:
+        if not 0 <= level <= 255:
+            print(f"Error: Keyer level must be between 0 and 255. Got {level}", file=sys.stderr)
+            return False
+        hr = decklink_dll.EnableOutputKeyer(output.handle, is_external)
+        if hr == S_OK:
+            hr = decklink_dll.SetOutputKeyerLevel(output.handle, ctypes.c_ubyte(level))
+    if hr != S_OK:
+        print(f"Output keyer update failed with HRESULT: {format_hresult(hr)}", file=sys.stderr)
+        return False
+    return True
 
 # --- Keyer Control Functions ---
 def enable_keyer(is_external: bool):
@@ -5,7 +5,7 @@ import logging
 import time
 import subprocess
 from abc import ABC, abstractmethod, ABCMeta
-from typing import Optional, List, Tuple, Dict, Any
+from typing import Optional, List, Tuple, Dict, Any, Callable
 
 # Third-party libraries
 import ffmpeg as ffmpeg
@@ -240,38 +240,71 @@ class TextLayerHandler(RenderLayerHandler):
 # =============================================================================
 
 class FFmpegDecodeThread(QThread):
-    """Decodes video frames in a separate thread."""
+    """
+    Decodes video frames in a separate thread.
+
+    By default frames are emitted as QImages for the renderer. With a frame_sink, FFmpeg scales
+    to output_size, converts to the card's frame rate and BGRA, paces itself to real time, and
+    each frame goes to frame_sink(bytes) on this thread (the DeckLink video layer path).
+    """
     frame_decoded = Signal(QImage)
     decoding_error = Signal(str)
     finished = Signal()
 
-    def __init__(self, video_path: str, parent=None):
+    def __init__(self, video_path: str, parent=None, frame_sink: Optional[Callable[[bytes], Any]] = None,
+                 output_size: Optional[QSize] = None, frame_rate: Optional[str] = None, scaling_mode: str = 'fit'):
         super().__init__(parent)
         self.video_path = video_path
         self._is_running = True
+        self._frame_sink = frame_sink
+        self._output_size = output_size
+        self._frame_rate = frame_rate # e.g. "60000/1001"
+        self._scaling_mode = scaling_mode
+
+    def _sink_stream(self):
+        """FFmpeg graph producing output_size BGRA at the card's rate, in real time."""
+        width, height = self._output_size.width(), self._output_size.height()
+        stream = ffmpeg.input(self.video_path, re=None, thread_queue_size=512)
+        if self._scaling_mode == 'fill':
+            stream = stream.filter('scale', width, height, force_original_aspect_ratio='increase').filter('crop', width, height)
+        elif self._scaling_mode == 'stretch':
+            stream = stream.filter('scale', width, height)
+        else: # fit: letterbox in black
+            stream = (stream.filter('scale', width, height, force_original_aspect_ratio='decrease')
+                      .filter('pad', width, height, '(ow-iw)/2', '(oh-ih)/2', color='black'))
+        if self._frame_rate:
+            stream = stream.filter('fps', fps=self._frame_rate)
+        return stream.output('pipe:', format='rawvideo', pix_fmt='bgra'), width, height
 
     def run(self):
         try:
-            probe = ffmpeg.probe(self.video_path)
-            video_info = next(s for s in probe['streams'] if s['codec_type'] == 'video')
-            width = int(video_info['width'])
-            height = int(video_info['height'])
-            
-            process = (
-                ffmpeg
-                .input(self.video_path, thread_queue_size=512)
-                .output('pipe:', format='rawvideo', pix_fmt='rgba')
-                .run_async(pipe_stdout=True, pipe_stderr=True)
-            )
+            if self._frame_sink is not None:
+                stream, width, height = self._sink_stream()
+            else:
+                probe = ffmpeg.probe(self.video_path)
+                video_info = next(s for s in probe['streams'] if s['codec_type'] == 'video')
+                width = int(video_info['width'])
+                height = int(video_info['height'])
+                stream = (
+                    ffmpeg
+                    .input(self.video_path, thread_queue_size=512)
+                    .output('pipe:', format='rawvideo', pix_fmt='rgba')
+                )
+            process = stream.run_async(pipe_stdout=True, pipe_stderr=True)
 
             while self._is_running:
                 in_bytes = process.stdout.read(width * height * 4)
-                if not in_bytes:
+                if not in_bytes or len(in_bytes) < width * height * 4:
                     break
+                if self._frame_sink is not None:
+                    self._frame_sink(in_bytes)
+                    continue
                 image = QImage(in_bytes, width, height, QImage.Format.Format_RGBA8888).copy()
                 if self._is_running:
                     self.frame_decoded.emit(image)
 
+            if process.poll() is None:
+                process.kill() # Stopped early, or the sink path: do not wait for a real-time ffmpeg to finish the file
             process.stdout.close()
             process.stderr.close()
             process.wait()
@@ -516,9 +516,27 @@ class MainWindow(QMainWindow, Ui_MainWindow):
             fill_idx = self.config_manager.get_app_setting("decklink_fill_device_index", 0) # Default 0
             key_idx = self.config_manager.get_app_setting("decklink_key_device_index", 2)  # Default 2
             mode_details = self.config_manager.get_app_setting("decklink_video_mode_details", None)
+            output_options = {
+                "fill_alpha_mode": self.config_manager.get_app_setting("decklink_fill_alpha_mode", "premultiplied"),
+                "pixel_format": self.config_manager.get_app_setting("decklink_pixel_format", "bgra"),
+                "worker_threads": self.config_manager.get_app_setting("decklink_worker_threads", 0),
+                "submit_queue_depth": self.config_manager.get_app_setting("decklink_submit_queue_depth", 0),
+                "submit_queue_policy": self.config_manager.get_app_setting("decklink_submit_queue_policy", "drop_oldest"),
+                "log_level": self.config_manager.get_app_setting("decklink_log_level", "info"),
+                "keying_mode": self.config_manager.get_app_setting("decklink_keying_mode", "external"),
+                "frame_memory": self.config_manager.get_app_setting("decklink_frame_memory", "precommitted"),
+                "frame_cache_mb": self.config_manager.get_app_setting("decklink_frame_cache_mb", 0),
+                "take_transition": self.config_manager.get_app_setting("decklink_take_transition", "cut"),
+                "transition_frames": self.config_manager.get_app_setting("decklink_transition_frames", 15),
+                "latency_profile": self.config_manager.get_app_setting("decklink_latency_profile", "fixed"),
+                "preroll_frames": self.config_manager.get_app_setting("decklink_preroll_frames", 0), # 0 = DLL default
+                "source_width": self.config_manager.get_app_setting("decklink_source_width", 0), # 0 = render at the mode's size
+                "source_height": self.config_manager.get_app_setting("decklink_source_height", 0),
+                "input_capture_device": self.config_manager.get_app_setting("decklink_input_capture_device", -1), # -1 = no capture
+            }
 
             # Delegate to OutputManager
-            success = self.output_manager.enable_decklink_output(fill_idx, key_idx, mode_details)
+            success = self.output_manager.enable_decklink_output(fill_idx, key_idx, mode_details, output_options)
             if success:
                 self.is_decklink_output_active = True
                 self.decklink_output_toggle_button.setStyleSheet("background-color: #4CAF50; border-radius: 12px;")
@@ -353,10 +353,15 @@ class SettingsWindow(QDialog):
             QMessageBox.warning(self, "DeckLink Error", f"Failed to initialize DeckLink API (HRESULT: {hr_init:#010x}).")
             return
 
-        device_count = ctypes.c_int(0)
-        hr = decklink_handler.decklink_dll.GetDeviceCount(ctypes.byref(device_count))
-
         device_list_for_combos = []
+        device_infos = decklink_handler.get_device_catalog() # Whole list in one call when the DLL supports it
+        if device_infos is not None:
+            hr = decklink_handler.S_OK
+            device_count = ctypes.c_int(len(device_infos))
+        else:
+            device_count = ctypes.c_int(0)
+            hr = decklink_handler.decklink_dll.GetDeviceCount(ctypes.byref(device_count))
+
         if hr != decklink_handler.S_OK or device_count.value == 0:
             msg = "No DeckLink devices found." if device_count.value == 0 else f"Error getting device count (HRESULT: {hr:#010x})."
             self.decklink_fill_device_combo.addItem(msg); self.decklink_fill_device_combo.setEnabled(False)
@@ -368,7 +373,9 @@ class SettingsWindow(QDialog):
             self.decklink_fill_device_combo.setEnabled(True)
             self.decklink_key_device_combo.setEnabled(True)
 
-            for i in range(device_count.value):
+            for info in device_infos or []:
+                device_list_for_combos.append({"text": f"{info['name']} (Index {info['index']})", "data": info["index"]})
+            for i in range(device_count.value if device_infos is None else 0):
                 name_buffer = ctypes.create_string_buffer(256)
                 hr_name = decklink_handler.decklink_dll.GetDeviceName(i, name_buffer, ctypes.sizeof(name_buffer))
                 if hr_name == decklink_handler.S_OK:
@@ -456,18 +463,19 @@ class SettingsWindow(QDialog):
         if device_index < 0:
             self.decklink_video_mode_combo.setEnabled(False)
         else:
-            # Placeholder modes with details as item data
-            # These should eventually be populated by querying the DeckLink device via the C++ DLL
-            modes = [
-                {"name": "1920x1080 @ 59.94", "width": 1920, "height": 1080, "fr_num": 60000, "fr_den": 1001},
-                {"name": "1920x1080 @ 30", "width": 1920, "height": 1080, "fr_num": 30000, "fr_den": 1000}, # Added 1080p30
-                # Add other common placeholder modes here if needed (e.g., 720p60, 1080i60)
-            ]
+            # Modes the device reports through the DLL's catalogue, with details as item data
+            modes = decklink_handler.get_display_modes(device_index)
+            if not modes:
+                # Older DLL or no catalogue: fall back to the common modes
+                modes = [
+                    {"name": "1920x1080 @ 59.94", "width": 1920, "height": 1080, "fr_num": 60000, "fr_den": 1001},
+                    {"name": "1920x1080 @ 30", "width": 1920, "height": 1080, "fr_num": 30000, "fr_den": 1000}, # Added 1080p30
+                ]
 
             # Determine default mode based on passed-in current_decklink_video_mode
             default_mode_name_to_select = "1920x1080 @ 30" # Fallback default
             if self._current_decklink_video_mode and isinstance(self._current_decklink_video_mode.get("name"), str):
-                # Check if the current mode's name is in our placeholder list
+                # Check if the current mode's name is in the list
                 for mode_option in modes:
                     if mode_option["name"] == self._current_decklink_video_mode["name"]:
                         default_mode_name_to_select = self._current_decklink_video_mode["name"]
@@ -477,7 +485,7 @@ class SettingsWindow(QDialog):
                 self.decklink_video_mode_combo.addItem(mode["name"], mode) # Store dict as data
                 if mode["name"] == default_mode_name_to_select:
                     default_index_to_set = i
-            self.decklink_video_mode_combo.setEnabled(True) # Enable for placeholder
+            self.decklink_video_mode_combo.setEnabled(True)
             # Set the default selection
             if default_index_to_set != -1:
                 self.decklink_video_mode_combo.setCurrentIndex(default_index_to_set)